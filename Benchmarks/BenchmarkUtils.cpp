@@ -0,0 +1,53 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#include "BenchmarkUtils.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace BenchmarkUtils {
+    thread_local bool countAllocationsOnThisThread = false;
+    thread_local uint64_t allocationCount = 0;
+    thread_local uint64_t allocatedBytes = 0;
+
+    static void recordAllocation(std::size_t size) {
+        if (countAllocationsOnThisThread) {
+            ++allocationCount;
+            allocatedBytes += size;
+        }
+    }
+}
+
+// ================================== Allocation hooks ==================================
+// Replace the global operator new/delete of the executable to count allocations (see ScopedAllocationCounter)
+
+void* operator new(std::size_t size) {
+    BenchmarkUtils::recordAllocation(size);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    BenchmarkUtils::recordAllocation(size);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    BenchmarkUtils::recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    BenchmarkUtils::recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
@@ -0,0 +1,155 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_BENCHMARKUTILS_H
+#define ULTRALIGHTJUCE_BENCHMARKUTILS_H
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Shared helpers for the benchmark executables in this folder: timing, allocation counting and a report that
+// can be printed to the console and written as JSON (so results can be tracked across releases).
+//
+// Allocations are counted by the global operator new/delete replacements in BenchmarkUtils.cpp, which every benchmark
+// executable compiles in (see CMakeLists.txt).
+
+namespace BenchmarkUtils {
+    // Allocations are only counted on threads that currently have a ScopedAllocationCounter alive.
+    // Defined in BenchmarkUtils.cpp, constant-initialised, so touching them from operator new is safe at any time.
+    extern thread_local bool countAllocationsOnThisThread;
+    extern thread_local uint64_t allocationCount;
+    extern thread_local uint64_t allocatedBytes;
+
+    /// \brief Counts the heap allocations (made through operator new) of the current thread while it is alive.
+    /// Allocations made by JavaScriptCore and Ultralight internally use their own allocators and are not counted.
+    class ScopedAllocationCounter {
+    public:
+        ScopedAllocationCounter() : previouslyCounting(countAllocationsOnThisThread),
+                                    startCount(allocationCount), startBytes(allocatedBytes) {
+            countAllocationsOnThisThread = true;
+        }
+
+        ~ScopedAllocationCounter() {
+            countAllocationsOnThisThread = previouslyCounting;
+        }
+
+        uint64_t getAllocations() const { return allocationCount - startCount; }
+        uint64_t getBytes() const { return allocatedBytes - startBytes; }
+
+    private:
+        bool previouslyCounting;
+        uint64_t startCount, startBytes;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    inline double nanosecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    /// \brief Returns the given percentile (0-100) of the values. Sorts the values in place.
+    inline double percentile(std::vector<double>& values, double percent) {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        auto index = static_cast<size_t>(percent / 100.0 * static_cast<double>(values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    /// \brief One measured benchmark case
+    struct Result {
+        juce::String name;
+        int64_t iterations = 0;
+        double nsPerCall = 0.0;
+        double allocationsPerCall = 0.0;
+        double bytesPerCall = 0.0;
+        // Additional, benchmark specific values (e.g. percentiles, array sizes)
+        juce::NamedValueSet extra;
+    };
+
+    /// \brief Runs function() iterations times (after one warm-up call) and measures time and allocations per call
+    template<typename Function>
+    Result measure(const juce::String& name, int64_t iterations, Function&& function) {
+        function();
+
+        ScopedAllocationCounter allocations;
+        auto start = Clock::now();
+        for (int64_t i = 0; i < iterations; ++i)
+            function();
+        auto elapsed = nanosecondsSince(start);
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nsPerCall = elapsed / static_cast<double>(iterations);
+        result.allocationsPerCall = static_cast<double>(allocations.getAllocations()) / static_cast<double>(iterations);
+        result.bytesPerCall = static_cast<double>(allocations.getBytes()) / static_cast<double>(iterations);
+        return result;
+    }
+
+    /// \brief Collects results, prints them and writes them as JSON
+    class Report {
+    public:
+        explicit Report(const juce::String& benchmarkName) : name(benchmarkName) {}
+
+        void add(Result result) {
+            std::cout << result.name.paddedRight(' ', 56)
+                      << juce::String(result.nsPerCall, 1).paddedLeft(' ', 14) << " ns/call"
+                      << juce::String(result.allocationsPerCall, 2).paddedLeft(' ', 10) << " allocs/call";
+            for (const auto& value : result.extra)
+                std::cout << "  " << value.name.toString() << "=" << value.value.toString();
+            std::cout << std::endl;
+            results.push_back(std::move(result));
+        }
+
+        juce::String toJSON() const {
+            auto* root = new juce::DynamicObject();
+            root->setProperty("benchmark", name);
+            root->setProperty("version", ProjectInfo::versionString);
+            root->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+            root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+            root->setProperty("cpu", juce::SystemStats::getCpuModel());
+            root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+
+            juce::Array<juce::var> resultList;
+            for (const auto& result : results) {
+                auto* entry = new juce::DynamicObject();
+                entry->setProperty("name", result.name);
+                entry->setProperty("iterations", result.iterations);
+                entry->setProperty("nsPerCall", result.nsPerCall);
+                entry->setProperty("allocationsPerCall", result.allocationsPerCall);
+                entry->setProperty("bytesPerCall", result.bytesPerCall);
+                for (const auto& value : result.extra)
+                    entry->setProperty(value.name, value.value);
+                resultList.add(juce::var(entry));
+            }
+            root->setProperty("results", resultList);
+            return juce::JSON::toString(juce::var(root));
+        }
+
+        /// \brief Writes the JSON report to the file given with --json <file>, if any
+        bool writeJSONIfRequested(const juce::ArgumentList& args) const {
+            if (!args.containsOption("--json"))
+                return true;
+            // getChildFile() also accepts absolute paths
+            auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--json"));
+            if (!file.replaceWithText(toJSON())) {
+                std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+                return false;
+            }
+            std::cout << "Results written to " << file.getFullPathName() << std::endl;
+            return true;
+        }
+
+    private:
+        juce::String name;
+        std::vector<Result> results;
+    };
+}
+
+#endif //ULTRALIGHTJUCE_BENCHMARKUTILS_H
@@ -0,0 +1,184 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+// Microbenchmarks for the C++/JS bridge (JSInteropBase). Runs headless: a view is created on the shared Ultralight
+// renderer but never shown, so this also runs on a Linux box without a display.
+//
+// Usage: UltralightJUCE_InteropBenchmark [--json results.json] [--quick]
+
+#include "BenchmarkUtils.h"
+
+#include <Ultralight/Ultralight.h>
+#include <AppCore/Platform.h>
+
+#include "PluginProcessor.h"
+#include "JSInteropBase.h"
+#include "JSInteropExample.h"
+
+using namespace BenchmarkUtils;
+
+// Page that provides the JS side of the benchmarks. APVTSUpdate() mirrors the parsing done in Resources/script.js.
+static const char* BENCHMARK_HTML = R"(
+<html><head><script>
+    const parser = new DOMParser();
+    let sink = 0;
+    function benchSink(...args) { sink += args.length; }
+    function benchJSNoop() {}
+    function APVTSUpdate(xml) {
+        const params = parser.parseFromString(xml, "text/xml").getElementsByTagName("PARAM");
+        for (let i = 0; i < params.length; i++)
+            sink += parseFloat(params[i].getAttribute("value"));
+    }
+</script></head><body></body></html>
+)";
+
+/// \brief Stands in for GUIMainComponent as the APVTS listener of the interop instance
+struct BenchmarkParameterListener : public juce::AudioProcessorValueTreeState::Listener {
+    void parameterChanged(const juce::String&, float) override {}
+};
+
+/// \brief Evaluates a script in the view and returns the time it took in nanoseconds
+static double timeScript(ultralight::View& view, const juce::String& script) {
+    ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
+    JSRetainPtr<JSStringRef> source = adopt(JSStringCreateWithUTF8CString(script.toRawUTF8()));
+    auto start = Clock::now();
+    JSEvaluateScript(context.get(), source.get(), nullptr, nullptr, 0, nullptr);
+    return nanosecondsSince(start);
+}
+
+/// \brief Measures a JS -> C++ call by running a loop in JS, minus the same loop calling an empty JS function
+static Result measureFromJS(ultralight::View& view, const juce::String& name, int64_t iterations,
+                            const juce::String& call, const juce::String& baselineCall) {
+    auto loop = [iterations](const juce::String& body) {
+        return "(function() { for (let i = 0; i < " + juce::String(iterations) + "; ++i) " + body + "; })();";
+    };
+    // Warm-up, so that the JIT has compiled both loops
+    timeScript(view, loop(call));
+    timeScript(view, loop(baselineCall));
+
+    ScopedAllocationCounter allocations;
+    auto total = timeScript(view, loop(call));
+    auto allocationCount = allocations.getAllocations();
+    auto bytes = allocations.getBytes();
+    auto baseline = timeScript(view, loop(baselineCall));
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerCall = juce::jmax(0.0, total - baseline) / static_cast<double>(iterations);
+    result.allocationsPerCall = static_cast<double>(allocationCount) / static_cast<double>(iterations);
+    result.bytesPerCall = static_cast<double>(bytes) / static_cast<double>(iterations);
+    result.extra.set("grossNsPerCall", total / static_cast<double>(iterations));
+    return result;
+}
+
+/// \brief Registers benchCallbackN with N float arguments
+template<size_t... Index>
+static void registerDispatchCallback(JSInteropBase& interop, std::index_sequence<Index...>) {
+    std::function<void(decltype(static_cast<void>(Index), 0.0f)...)> callback = [](auto...) {};
+    interop.registerCppCallbackInJS("benchCallback" + juce::String(sizeof...(Index)), callback);
+}
+
+template<size_t... NumArgs>
+static void registerDispatchCallbacks(JSInteropBase& interop, std::index_sequence<NumArgs...>) {
+    (registerDispatchCallback(interop, std::make_index_sequence<NumArgs>{}), ...);
+}
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const int64_t scale = args.containsOption("--quick") ? 10 : 1;
+
+    // Sets up the Ultralight platform and the shared renderer, exactly like the plugin does when its first editor opens
+    auto processor = std::make_unique<AudioPluginAudioProcessor>();
+    auto& renderer = AudioPluginAudioProcessor::getRenderer();
+
+    ultralight::RefPtr<ultralight::View> view = renderer->CreateView(256, 256, false, nullptr);
+    BenchmarkParameterListener listener;
+    JSInteropBase interop(*view, processor->parameters, listener);
+    view->set_load_listener(&interop);
+    view->LoadHTML(BENCHMARK_HTML);
+    while (view->is_loading()) {
+        renderer->Update();
+        juce::Thread::sleep(1);
+    }
+    renderer->Update();
+
+    registerDispatchCallbacks(interop, std::index_sequence<0, 1, 2, 3, 4, 5, 6, 7, 8>{});
+
+    Report report("interop");
+
+    // ================================== Ultralight bring-up ==================================
+    const auto startup = AudioPluginAudioProcessor::getUltralightStartupTimings();
+    Result startupResult;
+    startupResult.name = "Ultralight bring-up (once per process)";
+    startupResult.iterations = 1;
+    startupResult.nsPerCall = (startup.platformSetupMs + startup.rendererCreationMs) * 1.0e6;
+    startupResult.extra.set("platformSetupMs", startup.platformSetupMs);
+    startupResult.extra.set("rendererCreationMs", startup.rendererCreationMs);
+    report.add(std::move(startupResult));
+
+    // ================================== C++ -> JS: invokeMethod ==================================
+    const int64_t invokeIterations = 100000 / scale;
+    const juce::String shortString("gain"), longString = juce::String::repeatedString("abcdefgh", 128);
+    const std::vector<int> intList(16, 1);
+    const ExamplePreset preset{ "Init", 1, { 0.01f, 0.3f }, { { 0.1f, 0.2f }, { 0.3f, 0.4f } } };
+
+    report.add(measure("invokeMethod()", invokeIterations, [&] { interop.invokeMethod("benchSink"); }));
+    report.add(measure("invokeMethod(float)", invokeIterations, [&] { interop.invokeMethod("benchSink", 0.5f); }));
+    report.add(measure("invokeMethod(int)", invokeIterations, [&] { interop.invokeMethod("benchSink", 5); }));
+    report.add(measure("invokeMethod(bool)", invokeIterations, [&] { interop.invokeMethod("benchSink", true); }));
+    report.add(measure("invokeMethod(String[4])", invokeIterations, [&] { interop.invokeMethod("benchSink", shortString); }));
+    report.add(measure("invokeMethod(String[1024])", invokeIterations, [&] { interop.invokeMethod("benchSink", longString); }));
+    report.add(measure("invokeMethod(vector<int>[16])", invokeIterations, [&] { interop.invokeMethod("benchSink", intList); }));
+    report.add(measure("invokeMethod(struct)", invokeIterations, [&] { interop.invokeMethod("benchSink", preset); }));
+    report.add(measure("invokeMethod(int, String, vector<int>)", invokeIterations,
+                       [&] { interop.invokeMethod("benchSink", 2, shortString, intList); }));
+
+    // ================================== JS -> C++: registerCppCallbackInJS ==================================
+    const int64_t dispatchIterations = 200000 / scale;
+    juce::String arguments;
+    for (int numArgs = 0; numArgs <= 8; ++numArgs) {
+        auto argumentList = "(" + arguments + ")";
+        auto result = measureFromJS(*view, "registerCppCallbackInJS dispatch, " + juce::String(numArgs) + " args",
+                                    dispatchIterations, "benchCallback" + juce::String(numArgs) + argumentList,
+                                    "benchJSNoop" + argumentList);
+        result.extra.set("arguments", numArgs);
+        report.add(std::move(result));
+        arguments << (numArgs == 0 ? "" : ", ") << "i";
+    }
+
+    report.add(measureFromJS(*view, "OnParameterUpdate", dispatchIterations / 10,
+                             "OnParameterUpdate('gain', (i % 100) / 100)", "benchJSNoop('gain', (i % 100) / 100)"));
+
+    // ================================== Arrays ==================================
+    for (size_t size : { size_t(10), size_t(100), size_t(1000), size_t(10000), size_t(100000) }) {
+        const auto iterations = juce::jmax<int64_t>(10, static_cast<int64_t>(1000000 / size) / scale);
+        ultralight::Ref<ultralight::JSContext> context = view->LockJSContext();
+        JSContextRef ctx = context.get();
+
+        std::vector<float> values(size, 0.5f);
+        auto create = measure("CreateJSValue(vector<float>[" + juce::String((int64_t) size) + "])", iterations,
+                              [&] { JSInteropBase::CreateJSValue(ctx, values); });
+        create.extra.set("elements", (int64_t) size);
+        create.extra.set("nsPerElement", create.nsPerCall / static_cast<double>(size));
+        report.add(std::move(create));
+
+        JSValueRef jsArray = JSInteropBase::CreateJSValue(ctx, values);
+        JSValueProtect(ctx, jsArray);
+        auto get = measure("GetJSValueList<float>[" + juce::String((int64_t) size) + "]", iterations,
+                           [&] { JSInteropBase::GetJSValueList<float>(ctx, jsArray); });
+        get.extra.set("elements", (int64_t) size);
+        get.extra.set("nsPerElement", get.nsPerCall / static_cast<double>(size));
+        report.add(std::move(get));
+        JSValueUnprotect(ctx, jsArray);
+    }
+
+    // ================================== APVTS XML push ==================================
+    // The body of GUIMainComponent::parameterChanged(), including parsing on the JS side
+    report.add(measure("parameterChanged XML push", 10000 / scale, [&] { interop.pushAPVTSState(); }));
+
+    view->set_load_listener(nullptr);
+    return report.writeJSONIfRequested(args) ? 0 : 1;
+}
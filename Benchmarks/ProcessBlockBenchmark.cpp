@@ -0,0 +1,136 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+// Offline benchmark of AudioPluginAudioProcessor::processBlock. The processor is created without an editor (and
+// without bringing up Ultralight) and fed with generated audio, with parameter automation injected between blocks
+// like a host would. No audio device is needed.
+//
+// Usage: UltralightJUCE_ProcessBlockBenchmark [--json results.json]
+//            [--block-sizes 32,64,128,256,512,1024] [--channels 1,2] [--sample-rates 44100,48000,96000]
+//            [--seconds 20] [--automation-hz 50] [--quick]
+
+#include "BenchmarkUtils.h"
+
+#include "PluginProcessor.h"
+
+using namespace BenchmarkUtils;
+
+static juce::Array<int> getIntListOption(const juce::ArgumentList& args, const juce::String& option, const juce::String& defaultValue) {
+    auto text = args.containsOption(option) ? args.getValueForOption(option) : defaultValue;
+    juce::Array<int> values;
+    for (const auto& token : juce::StringArray::fromTokens(text, ",", ""))
+        if (token.getIntValue() > 0)
+            values.add(token.getIntValue());
+    return values;
+}
+
+/// \brief Streams secondsOfAudio through processBlock with one configuration and measures every block
+/// \return false if the processor doesn't support the configuration
+static bool runConfiguration(int blockSize, int numChannels, int sampleRate, double secondsOfAudio, double automationHz,
+                             Result& result) {
+    AudioPluginAudioProcessor processor;
+    const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    if (channelSet.size() != numChannels || !processor.setBusesLayout(layout)) {
+        std::cerr << "Layout with " << numChannels << " channels is not supported" << std::endl;
+        return false;
+    }
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto* gain = processor.parameters.getParameter("gain");
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(1);
+
+    const auto numBlocks = static_cast<size_t>(secondsOfAudio * sampleRate / blockSize);
+    if (numBlocks == 0) {
+        std::cerr << secondsOfAudio << " s are shorter than one block of " << blockSize << " samples" << std::endl;
+        return false;
+    }
+    const double blocksPerAutomationStep = automationHz > 0.0 ? sampleRate / (automationHz * blockSize) : 0.0;
+    std::vector<double> blockNanoseconds;
+    blockNanoseconds.reserve(numBlocks);
+    double totalNanoseconds = 0.0, nextAutomationBlock = 0.0;
+    uint64_t allocations = 0, allocatedBytes = 0;
+
+    for (size_t block = 0; block < numBlocks; ++block) {
+        // Input signal: a sine plus some noise (not timed)
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto* samples = buffer.getWritePointer(channel);
+            for (int i = 0; i < blockSize; ++i) {
+                const auto time = static_cast<double>(block * blockSize + i) / sampleRate;
+                samples[i] = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 440.0 * time))
+                             + 0.05f * (random.nextFloat() - 0.5f);
+            }
+        }
+
+        // Parameter automation, as a slow sine sweep of the gain (not timed, the host does this between blocks)
+        if (blocksPerAutomationStep > 0.0 && static_cast<double>(block) >= nextAutomationBlock) {
+            const auto time = static_cast<double>(block * blockSize) / sampleRate;
+            gain->setValueNotifyingHost(0.5f + 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 0.5 * time)));
+            nextAutomationBlock += blocksPerAutomationStep;
+        }
+
+        ScopedAllocationCounter counter;
+        auto start = Clock::now();
+        processor.processBlock(buffer, midi);
+        const auto elapsed = nanosecondsSince(start);
+        allocations += counter.getAllocations();
+        allocatedBytes += counter.getBytes();
+
+        totalNanoseconds += elapsed;
+        blockNanoseconds.push_back(elapsed);
+    }
+    processor.releaseResources();
+
+    result.name = "processBlock " + juce::String(blockSize) + " samples, " + juce::String(numChannels) + " ch, "
+                  + juce::String(sampleRate) + " Hz";
+    result.iterations = static_cast<int64_t>(numBlocks);
+    result.nsPerCall = totalNanoseconds / static_cast<double>(numBlocks);
+    result.allocationsPerCall = static_cast<double>(allocations) / static_cast<double>(numBlocks);
+    result.bytesPerCall = static_cast<double>(allocatedBytes) / static_cast<double>(numBlocks);
+    result.extra.set("blockSize", blockSize);
+    result.extra.set("channels", numChannels);
+    result.extra.set("sampleRate", sampleRate);
+    // The audio actually processed, numBlocks is rounded down from secondsOfAudio
+    const double processedSeconds = static_cast<double>(numBlocks) * blockSize / sampleRate;
+    result.extra.set("realtimeFactor", processedSeconds * 1.0e9 / totalNanoseconds);
+    result.extra.set("audioThreadAllocations", (int64_t) allocations);
+    const double budgetNanoseconds = 1.0e9 * blockSize / sampleRate;
+    result.extra.set("budgetNs", budgetNanoseconds);
+    result.extra.set("p50Ns", percentile(blockNanoseconds, 50.0));
+    result.extra.set("p90Ns", percentile(blockNanoseconds, 90.0));
+    result.extra.set("p99Ns", percentile(blockNanoseconds, 99.0));
+    result.extra.set("p999Ns", percentile(blockNanoseconds, 99.9));
+    // percentile() sorted the values, so the last one is the slowest block
+    result.extra.set("maxNs", blockNanoseconds.empty() ? 0.0 : blockNanoseconds.back());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto blockSizes = getIntListOption(args, "--block-sizes", "32,64,128,256,512,1024");
+    const auto channelCounts = getIntListOption(args, "--channels", "1,2");
+    const auto sampleRates = getIntListOption(args, "--sample-rates", "44100,48000,96000");
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue()
+                                                            : (args.containsOption("--quick") ? 2.0 : 20.0);
+    const double automationHz = args.containsOption("--automation-hz") ? args.getValueForOption("--automation-hz").getDoubleValue() : 50.0;
+
+    Report report("processBlock");
+    for (int sampleRate : sampleRates)
+        for (int numChannels : channelCounts)
+            for (int blockSize : blockSizes) {
+                Result result;
+                if (!runConfiguration(blockSize, numChannels, sampleRate, seconds, automationHz, result))
+                    return 1;
+                report.add(std::move(result));
+            }
+
+    return report.writeJSONIfRequested(args) ? 0 : 1;
+}
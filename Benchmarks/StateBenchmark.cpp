@@ -0,0 +1,143 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+// Compares the legacy XML state path (ValueTree -> XML -> copyXmlToBinary and back via replaceState) with the binary
+// format in StateSerializer.h, for states with many parameters plus some non-parameter (UI) state.
+//
+// Usage: UltralightJUCE_StateBenchmark [--json results.json] [--parameters 500] [--quick]
+
+#include "BenchmarkUtils.h"
+
+#include "StateSerializer.h"
+
+using namespace BenchmarkUtils;
+
+/// \brief Minimal processor that only holds a configurable number of parameters
+class StateBenchmarkProcessor : public juce::AudioProcessor {
+public:
+    explicit StateBenchmarkProcessor(int numParameters)
+            : parameters(*this, nullptr, "PARAMETERS", createLayout(numParameters)) {
+        // Some UI state next to the parameters, like a real editor would store it
+        juce::ValueTree ui("UI");
+        ui.setProperty("width", 1024, nullptr);
+        ui.setProperty("height", 700, nullptr);
+        for (int i = 0; i < 32; ++i)
+            ui.appendChild(juce::ValueTree("PANEL", { { "id", i }, { "open", i % 2 == 0 }, { "name", "Panel " + juce::String(i) } }), nullptr);
+        parameters.state.appendChild(ui, nullptr);
+    }
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createLayout(int numParameters) {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        for (int i = 0; i < numParameters; ++i)
+            layout.add(std::make_unique<juce::AudioParameterFloat>("param" + juce::String(i), "Parameter " + juce::String(i), 0.0f, 1.0f, 0.5f));
+        return layout;
+    }
+
+    /// \brief Sets every parameter to a value that depends on the seed, so a restore has to change all of them
+    void randomise(int seed) {
+        juce::Random random(seed);
+        for (auto* parameter : getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    const juce::String getName() const override { return "StateBenchmark"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+    juce::AudioProcessorValueTreeState parameters;
+};
+
+/// \brief Counts the parameter notifications a restore causes (each one triggers the UI push in GUIMainComponent)
+struct NotificationCounter : public juce::AudioProcessorValueTreeState::Listener {
+    void parameterChanged(const juce::String&, float) override { ++notifications; }
+    int64_t notifications = 0;
+};
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const int numParameters = args.containsOption("--parameters") ? args.getValueForOption("--parameters").getIntValue() : 500;
+    const int64_t iterations = args.containsOption("--quick") ? 20 : 200;
+
+    StateBenchmarkProcessor processor(numParameters);
+    NotificationCounter counter;
+    for (auto* parameter : processor.getParameters())
+        processor.parameters.addParameterListener(dynamic_cast<juce::RangedAudioParameter*>(parameter)->paramID, &counter);
+
+    // Two different states to alternate between, so every restore actually changes all parameters
+    juce::MemoryBlock xmlStates[2], binaryStates[2];
+    for (int i = 0; i < 2; ++i) {
+        processor.randomise(i + 1);
+        StateSerializer::writeLegacyXml(processor.parameters, xmlStates[i]);
+        StateSerializer::write(processor.parameters, binaryStates[i]);
+    }
+
+    Report report("state");
+    int index = 0;
+    auto addSizes = [numParameters](Result result, const juce::MemoryBlock& state) {
+        result.extra.set("parameters", numParameters);
+        result.extra.set("stateBytes", (int64_t) state.getSize());
+        return result;
+    };
+
+    juce::MemoryBlock destination;
+    auto xmlSave = addSizes(measure("save (XML)", iterations, [&] {
+        destination.reset();
+        StateSerializer::writeLegacyXml(processor.parameters, destination);
+    }), xmlStates[0]);
+    auto binarySave = addSizes(measure("save (binary)", iterations, [&] {
+        destination.reset();
+        StateSerializer::write(processor.parameters, destination);
+    }), binaryStates[0]);
+    const double saveSpeedup = xmlSave.nsPerCall / binarySave.nsPerCall;
+    report.add(std::move(xmlSave));
+    report.add(std::move(binarySave));
+
+    counter.notifications = 0;
+    auto xmlLoad = addSizes(measure("load (XML, replaceState)", iterations, [&] {
+        index ^= 1;
+        StateSerializer::readLegacyXml(processor.parameters, xmlStates[index].getData(), static_cast<int>(xmlStates[index].getSize()));
+    }), xmlStates[0]);
+    xmlLoad.extra.set("notificationsPerLoad", static_cast<double>(counter.notifications) / static_cast<double>(iterations + 1));
+    const double xmlLoadNs = xmlLoad.nsPerCall;
+    report.add(std::move(xmlLoad));
+
+    counter.notifications = 0;
+    auto binaryLoad = addSizes(measure("load (binary)", iterations, [&] {
+        index ^= 1;
+        StateSerializer::readBinary(processor.parameters, binaryStates[index].getData(), static_cast<int>(binaryStates[index].getSize()));
+    }), binaryStates[0]);
+    binaryLoad.extra.set("notificationsPerLoad", static_cast<double>(counter.notifications) / static_cast<double>(iterations + 1));
+    const double loadSpeedup = xmlLoadNs / binaryLoad.nsPerCall;
+    report.add(std::move(binaryLoad));
+
+    // Legacy blobs through the new entry point (detects the format and falls back to XML)
+    report.add(addSizes(measure("load (XML through StateSerializer::read)", iterations, [&] {
+        index ^= 1;
+        StateSerializer::read(processor.parameters, xmlStates[index].getData(), static_cast<int>(xmlStates[index].getSize()));
+    }), xmlStates[0]));
+
+    // The comparison the binary format is about, in one line
+    std::cout << std::endl << "binary vs. XML with " << numParameters << " parameters: save "
+              << juce::String(saveSpeedup, 1) << "x faster, load " << juce::String(loadSpeedup, 1) << "x faster, "
+              << juce::String(static_cast<double>(xmlStates[0].getSize()) / static_cast<double>(binaryStates[0].getSize()), 1)
+              << "x smaller" << std::endl;
+
+    for (auto* parameter : processor.getParameters())
+        processor.parameters.removeParameterListener(dynamic_cast<juce::RangedAudioParameter*>(parameter)->paramID, &counter);
+    return report.writeJSONIfRequested(args) ? 0 : 1;
+}
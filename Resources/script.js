@@ -13,6 +13,7 @@ const parser = new DOMParser();
 /**
  * Called by JUCE whenever there is a change in the APVTS parameters, for the call see parameterChanged() method in
  * GUIMainComponent.h.
+ * Not called for pages that read the parameters from window.ParameterMirror and called DisableAPVTSPush(), see mirrorFrame().
  * @param xml The XML string containing the APVTS parameters. You can parse this and update your UI accordingly as below,
  * or write some more advanced logic to do more complex state management for your UI elements.
  * @constructor
@@ -45,53 +46,229 @@ function APVTSUpdate(xml) {
     }
 }
 
+/**
+ * Called by JUCE a few times per second with the load of the audio thread, see timerCallback() in GUIMainComponent.h.
+ * @param stats Loads are in percent of the real-time budget of a block
+ * ({ currentLoad, meanLoad, maxLoad, p50Load, p95Load, p99Load, budgetMs, maxBlockMs, blocks, deadlineMisses })
+ */
+function AudioLoadUpdate(stats) {
+    const element = document.querySelector('#audioLoad');
+    element.textContent = "DSP " + stats.currentLoad.toFixed(1) + "% (p99 " + stats.p99Load.toFixed(1)
+        + "%, max " + stats.maxLoad.toFixed(1) + "%) | misses: " + stats.deadlineMisses;
+    element.classList.toggle('warning', stats.deadlineMisses > 0 || stats.p99Load > 80);
+}
+
+/**
+ * Called by JUCE together with AudioLoadUpdate() with the input-to-photon latency of this view, see InputLatencyMeter.h.
+ * Only input whose handler calls MarkInputHandled() (when it changed what is shown) is measured, other repaints of the
+ * page (like these readouts) aren't attributed to input.
+ * @param stats Latencies in ms
+ * ({ p50Ms, p95Ms, p99Ms, maxMs, meanMs, frames, dropped, handledP50Ms, handledP99Ms, handled })
+ */
+function InputLatencyUpdate(stats) {
+    if (stats.frames === 0)
+        return;
+    const element = document.querySelector('#inputLatency');
+    let text = "Input " + stats.p50Ms.toFixed(1) + " ms (p99 " + stats.p99Ms.toFixed(1) + " ms)";
+    if (stats.handled > 0)
+        text += " | handled after " + stats.handledP50Ms.toFixed(1) + " ms";
+    element.textContent = text;
+    // More than two frames at 60 Hz feels laggy
+    element.classList.toggle('warning', stats.p99Ms > 33);
+}
+
+/**
+ * Called by JUCE together with AudioLoadUpdate() with the frame times during interaction and the JS garbage
+ * collections done while the UI was idle, see IdleGarbageCollector.h. Compare interactionP99Ms across
+ * IDLE_GC_AGGRESSIVENESS settings (Config.h) to see the effect of idle collection.
+ * @param stats Times in ms ({ interactionP50Ms, interactionP99Ms, interactionMaxMs, interactionFrames, collections,
+ * collectionP50Ms, collectionMaxMs, aggressiveness })
+ */
+function FrameTimeUpdate(stats) {
+    if (stats.interactionFrames === 0)
+        return;
+    const element = document.querySelector('#frameTime');
+    element.textContent = "Frame " + stats.interactionP50Ms.toFixed(1) + " ms (p99 " + stats.interactionP99Ms.toFixed(1)
+        + " ms) | idle GCs: " + stats.collections;
+    // A frame at 60 Hz has 16.7 ms
+    element.classList.toggle('warning', stats.interactionP99Ms > 16.7);
+}
+
+// Memory samples received so far (oldest first), for trends
+const memoryHistory = [];
+const MEMORY_HISTORY_LENGTH = 120;
+
+/**
+ * Called by JUCE every few seconds with the memory used by this editor, its page and the renderer,
+ * see MemoryAccounting.h. The page keeps a history so that leaks show up as trends.
+ * @param snapshot Sizes in bytes ({ timeSeconds, viewBitmapBytes, inspectorBitmapBytes, imageBytes,
+ * inspectorImageBytes, jsHeapAvailable, jsHeapBytes, jsHeapCapacityBytes, jsExtraMemoryBytes, jsObjectCount,
+ * interopStringsCreated, interopStringsReleased, interopFunctionWrappers, rendererViewBitmapBytes,
+ * rendererEstimatedBytes, processResidentBytes, rendererViews })
+ */
+function MemoryUpdate(snapshot) {
+    memoryHistory.push(snapshot);
+    if (memoryHistory.length > MEMORY_HISTORY_LENGTH)
+        memoryHistory.shift();
+
+    const mb = (bytes) => (bytes / (1024 * 1024)).toFixed(1);
+    const editorBytes = snapshot.viewBitmapBytes + snapshot.inspectorBitmapBytes
+        + snapshot.imageBytes + snapshot.inspectorImageBytes;
+    const leakedStrings = snapshot.interopStringsCreated - snapshot.interopStringsReleased;
+    let text = "Editor " + mb(editorBytes) + " MB";
+    if (snapshot.jsHeapAvailable)
+        text += " | JS " + mb(snapshot.jsHeapBytes) + " MB";
+    text += " | renderer " + mb(snapshot.rendererEstimatedBytes) + " MB | JSStrings " + leakedStrings;
+
+    // Growth per minute over the history (needs a minute of samples to be meaningful)
+    const first = memoryHistory[0];
+    const minutes = (snapshot.timeSeconds - first.timeSeconds) / 60;
+    let growing = false;
+    if (minutes >= 1) {
+        const processGrowth = (snapshot.processResidentBytes - first.processResidentBytes) / minutes;
+        text += " (" + (processGrowth >= 0 ? "+" : "") + mb(processGrowth) + " MB/min";
+        if (snapshot.jsHeapAvailable) {
+            const heapGrowth = (snapshot.jsHeapBytes - first.jsHeapBytes) / minutes;
+            text += ", JS " + (heapGrowth >= 0 ? "+" : "") + mb(heapGrowth) + " MB/min";
+        }
+        text += ")";
+        // Unreleased interop strings keep piling up, or the process grows steadily while nothing happens
+        const leakedBefore = first.interopStringsCreated - first.interopStringsReleased;
+        growing = leakedStrings > leakedBefore || processGrowth > 1024 * 1024;
+    }
+    const element = document.querySelector('#memory');
+    element.textContent = text;
+    element.classList.toggle('warning', growing);
+}
+
 /**
  * Dummy function to show how to call a JS function from JUCE, see JSInteropExample.h.
  */
 function myJSFunction(...args) {
     console.log("myJSFunction called with arguments: ");
     for (let i = 0; i < args.length; i++) {
-        console.log("Argument " + (i + 1) + ": " + args[i]);
+        // Structs from C++ arrive as plain objects, stringify them for logging
+        const arg = typeof args[i] === "object" && !Array.isArray(args[i]) ? JSON.stringify(args[i]) : args[i];
+        console.log("Argument " + (i + 1) + ": " + arg);
     }
     console.log();
 }
 
+// ========================================================================================================
+// Preset browsing
+// ========================================================================================================
+
+// Only the visible page of presets is ever fetched from C++
+const PRESETS_PER_PAGE = 10;
+let presetPage = 0;
+
+/**
+ * Called by JUCE when a search started with PresetSearch() has finished, see JSInteropExample.h.
+ * @param numResults The number of presets matching the search
+ */
+function PresetSearchResults(numResults) {
+    presetPage = 0;
+    showPresetPage();
+}
+
+function showPresetPage() {
+    const numResults = PresetGetNumResults();
+    const numPages = Math.max(1, Math.ceil(numResults / PRESETS_PER_PAGE));
+    presetPage = Math.min(Math.max(presetPage, 0), numPages - 1);
+
+    const list = document.querySelector('#presetList');
+    list.innerHTML = "";
+    // Array of { index, name, category, tags } objects, converted from C++ structs
+    for (const preset of PresetGetPage(presetPage * PRESETS_PER_PAGE, PRESETS_PER_PAGE)) {
+        const item = document.createElement("li");
+        item.textContent = preset.name + (preset.category ? " (" + preset.category + ")" : "");
+        item.addEventListener('click', () => PresetApply(preset.index));
+        list.appendChild(item);
+    }
+    document.querySelector('#presetPageInfo').textContent = numResults > 0
+        ? (presetPage + 1) + " / " + numPages + " (" + numResults + " presets)"
+        : "No presets";
+}
+
+function searchPresets() {
+    PresetSearch(document.querySelector('#presetQuery').value, document.querySelector('#presetCategory').value, "");
+}
+
+window.addEventListener('DOMContentLoaded', (event) => {
+    const categorySelect = document.querySelector('#presetCategory');
+    for (const category of PresetGetCategories()) {
+        const option = document.createElement("option");
+        option.value = category;
+        option.textContent = category;
+        categorySelect.appendChild(option);
+    }
+    categorySelect.addEventListener('change', searchPresets);
+    document.querySelector('#presetQuery').addEventListener('input', searchPresets);
+    document.querySelector('#presetPrev').addEventListener('click', () => { presetPage--; showPresetPage(); });
+    document.querySelector('#presetNext').addEventListener('click', () => { presetPage++; showPresetPage(); });
+    showPresetPage();
+});
+
 // ========================================================================================================
 // UI related code
 // ========================================================================================================
 
+// Current value of the gain knob (0-1)
+let gainValue = 0;
+
 /**
  * Update the Gain knob UI
  * @param value
  * @constructor
  */
 function gainUpdate(value){
-    // Rotate the gain knob
-    // Map value from 0-1 to -145 to 145
-    value = value * 290 - 145;
-    var knob = document.querySelector('#gain svg');
-    knob.style.transform = "rotate(" + value + "deg)";
+    gainValue = Number(value);
+    // Show the frame of the pre-rendered knob for the value (rotated from -145 to 145 degrees, see Source/SpriteAtlas.h)
+    SpriteAtlas.setFrame(document.querySelector('#gain .knobSprite'), 'gainKnob', gainValue);
+    // Query the parameter's text representation from C++, the result is returned synchronously
+    document.querySelector('#gainText').textContent = GetParameterText("gain");
+}
+
+/**
+ * True if value i of the ParameterMirror changed since the dirty bits were last cleared (see ParameterMirror.h)
+ * @param i Index into ParameterMirror.values, e.g. ParameterMirror.index.gain
+ */
+function mirrorValueChanged(i) {
+    return (ParameterMirror.dirty[i >> 5] & (1 << (i & 31))) !== 0;
+}
+
+/**
+ * Reads parameter changes from the ParameterMirror once per frame instead of receiving APVTSUpdate() messages.
+ * JUCE updates the mirror right before the frame's requestAnimationFrame() callbacks run; the dirty bits accumulate
+ * until they are cleared here, so changes in frames without a callback are not missed.
+ */
+function mirrorFrame() {
+    if (mirrorValueChanged(ParameterMirror.index.gain))
+        gainUpdate(ParameterMirror.values[ParameterMirror.index.gain]);
+    // Acknowledge the changes that were read
+    ParameterMirror.dirty.fill(0);
+    requestAnimationFrame(mirrorFrame);
 }
 
 window.addEventListener('DOMContentLoaded', (event) => {
+    // This page redraws every frame anyway, so it reads the parameters from the mirror and needs no XML pushes
+    if (window.ParameterMirror) {
+        DisableAPVTSPush();
+        requestAnimationFrame(mirrorFrame);
+    }
+
     // Get the knob element
-    var knob = document.querySelector('#gain svg');
+    var knob = document.querySelector('#gain .knobSprite');
 
     // Variables to track mouse movement
     var isDragging = false;
-    var startPosX, startPosY;
-    var startAngle = 0;
+    var startPosY;
+    var startValue = 0;
 
-    // Function to calculate the angle based on mouse movement
-    function calculateAngle(posX, posY) {
+    // Function to calculate the value based on mouse movement (290 px for the whole range)
+    function calculateValue(posY) {
         var deltaY = posY - startPosY;
-        var angle = startAngle - deltaY;
-        var maxAngle = 145;
-        if(angle < -maxAngle)
-            angle = -maxAngle;
-        if(angle > maxAngle)
-            angle = maxAngle;
-        return angle;
+        return Math.min(Math.max(startValue - deltaY / 290, 0), 1);
     }
 
     // Event listener for mouse down event
@@ -99,27 +276,31 @@ window.addEventListener('DOMContentLoaded', (event) => {
         isDragging = true;
         // Add dragging class to the knob
         knob.classList.add('dragging');
-        startPosX = event.clientX;
         startPosY = event.clientY;
-        startAngle = parseFloat(knob.style.transform.replace('rotate(', '').replace('deg)', '')) || 0;
+        startValue = gainValue;
+        MarkInputHandled();
     });
 
     // Event listener for mouse move event
     document.addEventListener('mousemove', function (event) {
         if (isDragging) {
-            var angle = calculateAngle(event.clientX, event.clientY);
+            var value = calculateValue(event.clientY);
             // Update the gain value in JUCE
-            let juceGain = (angle + 145) / 290;
-            OnParameterUpdate("gain", juceGain);
-            // Using jQuery
-            $('#gain svg').css('transform', 'rotate(' + angle + 'deg)');
+            OnParameterUpdate("gain", value);
+            // A bitmap blit from the sprite atlas, no vector rasterization
+            gainValue = value;
+            SpriteAtlas.setFrame(knob, 'gainKnob', value);
+            MarkInputHandled();
         }
     });
 
     // Event listener for mouse up event
     document.addEventListener('mouseup', function () {
+        if (!isDragging)
+            return;
         isDragging = false;
         // Remove dragging class from the knob
         knob.classList.remove('dragging');
+        MarkInputHandled();
     });
 });
\ No newline at end of file
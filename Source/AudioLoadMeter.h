@@ -0,0 +1,102 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_AUDIOLOADMETER_H
+#define ULTRALIGHTJUCE_AUDIOLOADMETER_H
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+#include "LockFreeHistogram.h"
+
+/// \brief Measures how much of the real-time budget processBlock uses. The budget of a block is its duration
+/// (numSamples / sampleRate), anything above 100% is a deadline miss (an xrun, if the host has no spare time).
+/// Writing happens on the audio thread through ScopedMeasurement and is lock-free and allocation-free, reading
+/// (getStats()) can happen on any thread, e.g. to show the load in the web UI.
+class AudioLoadMeter {
+public:
+    /// \brief Snapshot of the measured load. Loads are in percent of the real-time budget.
+    struct Stats {
+        double currentLoad = 0.0;
+        double meanLoad = 0.0;
+        double maxLoad = 0.0;
+        double p50Load = 0.0;
+        double p95Load = 0.0;
+        double p99Load = 0.0;
+        double budgetMs = 0.0;      // Budget of a block of the size announced in prepareToPlay
+        double maxBlockMs = 0.0;    // Longest processBlock call
+        uint64_t blocks = 0;
+        uint64_t deadlineMisses = 0;
+    };
+
+    /// \brief Times one processBlock call, create it at the top of processBlock
+    class ScopedMeasurement {
+    public:
+        ScopedMeasurement(AudioLoadMeter& meterIn, int numSamplesIn) noexcept
+                : meter(meterIn), numSamples(numSamplesIn), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedMeasurement() {
+            meter.addMeasurement(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start), numSamples);
+        }
+
+    private:
+        AudioLoadMeter& meter;
+        const int numSamples;
+        const juce::int64 start;
+    };
+
+    /// \brief Call from prepareToPlay. Resets all statistics.
+    void prepare(double sampleRateIn, int samplesPerBlockIn) {
+        sampleRate.store(sampleRateIn);
+        samplesPerBlock.store(samplesPerBlockIn);
+        reset();
+    }
+
+    void reset() noexcept {
+        loadHistogram.reset();
+        blockDurations.reset();
+        deadlineMisses.store(0);
+        currentLoad.store(0.0);
+    }
+
+    void addMeasurement(double elapsedSeconds, int numSamples) noexcept {
+        const double rate = sampleRate.load(std::memory_order_relaxed);
+        if (numSamples <= 0 || rate <= 0.0)
+            return;
+        const double load = 100.0 * elapsedSeconds * rate / static_cast<double>(numSamples);
+        loadHistogram.add(load);
+        blockDurations.add(elapsedSeconds * 1000.0);
+        currentLoad.store(load, std::memory_order_relaxed);
+        if (load > 100.0)
+            deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Stats getStats() const noexcept {
+        Stats stats;
+        stats.currentLoad = currentLoad.load(std::memory_order_relaxed);
+        stats.meanLoad = loadHistogram.getMean();
+        stats.maxLoad = loadHistogram.getMax();
+        stats.p50Load = loadHistogram.getPercentile(50.0);
+        stats.p95Load = loadHistogram.getPercentile(95.0);
+        stats.p99Load = loadHistogram.getPercentile(99.0);
+        const double rate = sampleRate.load(std::memory_order_relaxed);
+        stats.budgetMs = rate > 0.0 ? 1000.0 * samplesPerBlock.load(std::memory_order_relaxed) / rate : 0.0;
+        stats.maxBlockMs = blockDurations.getMax();
+        stats.blocks = loadHistogram.getCount();
+        stats.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<int> samplesPerBlock { 0 };
+    // Load in percent, 0.5% resolution up to 200%
+    LockFreeHistogram<400> loadHistogram { 200.0 };
+    // Block durations in ms (only the maximum is used)
+    LockFreeHistogram<1> blockDurations { 1000.0 };
+    std::atomic<double> currentLoad { 0.0 };
+    std::atomic<uint64_t> deadlineMisses { 0 };
+};
+
+#endif //ULTRALIGHTJUCE_AUDIOLOADMETER_H
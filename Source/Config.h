@@ -6,8 +6,19 @@
 #define ULTRALIGHTJUCE_CONFIG_H
 
 // Location of your HTML/JS/CSS resources. Can be anywhere on your machine.
+// Only used with ULTRALIGHTJUCE_LOOSE_RESOURCES=ON (otherwise the resources compiled into the binary are served), and
+// for files that are not compiled in, like the inspector.
 const std::string JS_RESOURCES_PATH = "C:\\Users\\Max\\CLionProjects\\ultralight-juce\\Resources";
 // Location of the Ultralight SDK resources.
 const ultralight::String16 ULTRALIGHT_RESOURCES_PATH = "C:\\Users\\Max\\CLionProjects\\ultralight-juce\\Libs\\ultralight-sdk\\bin\\resources";
 
+// Present the UI through OpenGL (dirty rectangles streamed into a texture, see OpenGLPresenter.h) instead of drawing
+// a juce::Image with juce::Graphics. Falls back to juce::Graphics if OpenGL 3.2 isn't available.
+const bool USE_OPENGL_PRESENTER = false;
+
+// How eagerly JavaScript garbage is collected while the UI is idle, so collections don't interrupt interactions
+// (see IdleGarbageCollector.h): 0 = off (JavaScriptCore decides), 1 = hint, 2 = young generation, 3 = full heap.
+// 2 and 3 use JavaScriptCore's debugging API, only set them to measure.
+const int IDLE_GC_AGGRESSIVENESS = 1;
+
 #endif //ULTRALIGHTJUCE_CONFIG_H
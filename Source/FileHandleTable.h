@@ -0,0 +1,115 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_FILEHANDLETABLE_H
+#define ULTRALIGHTJUCE_FILEHANDLETABLE_H
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FileSystem.h>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// \brief The open files of a FileSystem that serves some files itself and passes the others on to an inner
+/// FileSystem (see ResourceFileSystem and SharedResourceCache).
+///
+/// Every handle it hands out is an index into one table, whose entry records the owner: either the outer FileSystem,
+/// with its own state of the open file (OpenFile, e.g. the read position), or the inner FileSystem, with the inner
+/// handle. So the two never collide, whatever the width of ultralight::FileHandle on the platform (it is an int on
+/// Linux and macOS). invalidFileHandle is never handed out. Freed slots are reused.
+///
+/// All methods are thread-safe, Ultralight opens and reads files from its own threads.
+template<typename OpenFile>
+class FileHandleTable {
+public:
+    /// \brief Registers a file served by the outer FileSystem
+    ultralight::FileHandle addOwn(OpenFile file) {
+        Entry entry;
+        entry.own = true;
+        entry.file = std::move(file);
+        return add(std::move(entry));
+    }
+
+    /// \brief Registers a file opened by the inner FileSystem. Passes invalidFileHandle through.
+    ultralight::FileHandle addInner(ultralight::FileHandle innerHandle) {
+        if (innerHandle == ultralight::invalidFileHandle)
+            return ultralight::invalidFileHandle;
+        Entry entry;
+        entry.innerHandle = innerHandle;
+        return add(std::move(entry));
+    }
+
+    /// \brief The inner handle of a file opened by the inner FileSystem
+    /// \return false if the handle is not one of the inner FileSystem
+    bool getInnerHandle(ultralight::FileHandle handle, ultralight::FileHandle& innerHandle) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto* entry = find(handle);
+        if (entry == nullptr || entry->own)
+            return false;
+        innerHandle = entry->innerHandle;
+        return true;
+    }
+
+    /// \brief Calls function(OpenFile&) with the table locked if the handle is a file of the outer FileSystem
+    /// \return function's result, or notFound if the handle is not one of ours
+    template<typename Result, typename Function>
+    Result withOwnFile(ultralight::FileHandle handle, Result notFound, Function&& function) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto* entry = find(handle);
+        if (entry == nullptr || !entry->own)
+            return notFound;
+        return function(entry->file);
+    }
+
+    /// \brief Frees the handle
+    /// \return The inner handle to close, or invalidFileHandle if the file was one of ours (or the handle unknown)
+    ultralight::FileHandle remove(ultralight::FileHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto* entry = find(handle);
+        if (entry == nullptr)
+            return ultralight::invalidFileHandle;
+        const auto innerHandle = entry->own ? ultralight::invalidFileHandle : entry->innerHandle;
+        *entry = {};
+        return innerHandle;
+    }
+
+private:
+    struct Entry {
+        bool used = false;
+        bool own = false;
+        ultralight::FileHandle innerHandle = ultralight::invalidFileHandle;
+        OpenFile file {};
+    };
+
+    ultralight::FileHandle add(Entry entry) {
+        entry.used = true;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (!entries[i].used) {
+                entries[i] = std::move(entry);
+                return static_cast<ultralight::FileHandle>(i);
+            }
+        }
+        entries.push_back(std::move(entry));
+        return static_cast<ultralight::FileHandle>(entries.size() - 1);
+    }
+
+    // Call with the mutex locked
+    Entry* find(ultralight::FileHandle handle) {
+        // Negative handles become large indices, so one comparison covers them
+        if (handle == ultralight::invalidFileHandle || static_cast<size_t>(handle) >= entries.size())
+            return nullptr;
+        auto& entry = entries[static_cast<size_t>(handle)];
+        return entry.used ? &entry : nullptr;
+    }
+
+    const Entry* find(ultralight::FileHandle handle) const {
+        return const_cast<FileHandleTable*>(this)->find(handle);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+};
+
+#endif //ULTRALIGHTJUCE_FILEHANDLETABLE_H
@@ -1,18 +1,49 @@
 #pragma once
 
+#include <algorithm>              // Header for std::min/std::max
+#include <atomic>                 // Header for atomic flags
 #include <chrono>                 // Header for time-related utilities
+#include <cstdint>                // Header for fixed width integers
 #include <filesystem>             // Header for file system operations
+#include <fstream>                // Header for reading files (content hashes)
 #include <functional>             // Header for function objects
 #include <future>                 // Header for asynchronous operations
+#include <mutex>                  // Header for mutual exclusion
+#include <set>                    // Header for ordered set container
 #include <thread>                 // Header for multithreading support
 #include <unordered_map>          // Header for unordered map container
+#include <vector>                 // Header for vector container
 
+#if defined(__linux__)
+#include <cerrno>                 // Header for errno
+#include <cstdio>                 // Header for fprintf (errors)
+#include <cstring>                // Header for strerror
+#include <poll.h>                 // Header for poll()
+#include <sys/eventfd.h>          // Header for eventfd (wakes the watcher thread on Stop())
+#include <sys/inotify.h>          // Header for inotify
+#include <unistd.h>               // Header for read() and close()
+#endif
+
+// Watches a directory (recursively) and calls the registered callbacks when files change.
+// On Linux, changes are reported by inotify as they happen. Bursts of writes (e.g. an editor saving several files, or
+// writing one file in chunks) are coalesced, so each changed file is reported once per burst. A burst is reported after
+// `coalesce` without changes, or after `maxDelay` at the latest, so a file that is written continuously still reloads.
+// If inotify drops events (queue overflow), everything is compared against the known hashes again.
+// Everywhere else, or if inotify is not available (or fails), the directory is polled every `delay`.
+// A file only counts as changed if its contents changed (compared by hash), so saving without changes or touching
+// a file doesn't trigger anything.
+//
+// Callbacks are registered for a pattern, which is either an exact path relative to the watched directory
+// (e.g. "img/knob.svg"), an exact file name (e.g. "index.html") or a glob with * and ? (e.g. "*.css", "img/*").
+// Exact patterns are looked up in a hash map, only globs are matched one by one.
 class FileWatcher {
 public:
     using Callback = std::function<void(const std::string&)>;   // Type alias for callback function
 
-    explicit FileWatcher(const std::string& path, std::chrono::duration<int, std::milli> delay = std::chrono::milliseconds(500))
-            : path_(path), delay_(delay), running_(false) {}
+    explicit FileWatcher(const std::string& path, std::chrono::duration<int, std::milli> delay = std::chrono::milliseconds(500),
+                         std::chrono::duration<int, std::milli> coalesce = std::chrono::milliseconds(50),
+                         std::chrono::duration<int, std::milli> maxDelay = std::chrono::milliseconds(500))
+            : path_(path), delay_(delay), coalesce_(coalesce), maxDelay_(maxDelay), running_(false) {}
 
     ~FileWatcher() {
         Stop();
@@ -21,7 +52,14 @@ public:
     void Start() {
         if (!running_) {
             running_ = true;
+#if defined(__linux__)
+            wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
             thread_ = std::thread([this]() {
+#if defined(__linux__)
+                if (WatchLoopInotify())
+                    return;
+#endif
                 WatchLoop();
             });
         }
@@ -30,56 +68,327 @@ public:
     void Stop() {
         if (running_) {
             running_ = false;
+#if defined(__linux__)
+            if (wakeFd_ >= 0) {
+                uint64_t one = 1;
+                (void) write(wakeFd_, &one, sizeof(one));
+            }
+#endif
             thread_.join();
+#if defined(__linux__)
+            if (wakeFd_ >= 0) {
+                close(wakeFd_);
+                wakeFd_ = -1;
+            }
+#endif
         }
     }
 
-    // Add a callback function to be executed when a file is changed
-    void AddCallback(const std::string& filename, std::function<void(const std::string&)> callback) {
-        callbacks_[filename] = std::move(callback);
+    // Add a callback function to be executed when a file matching the pattern is changed (thread-safe)
+    void AddCallback(const std::string& pattern, std::function<void(const std::string&)> callback) {
+        std::lock_guard<std::mutex> lock(callbacksMutex_);
+        if (IsGlob(pattern)) {
+            for (auto& glob : globCallbacks_) {
+                if (glob.first == pattern) {
+                    glob.second = std::move(callback);
+                    return;
+                }
+            }
+            globCallbacks_.emplace_back(pattern, std::move(callback));
+        } else {
+            callbacks_[pattern] = std::move(callback);
+        }
     }
 
-    // Remove a callback function for a specific file
-    void RemoveCallback(const std::string& filename) {
-        callbacks_.erase(filename);
+    // Remove the callback function of a pattern (thread-safe)
+    void RemoveCallback(const std::string& pattern) {
+        std::lock_guard<std::mutex> lock(callbacksMutex_);
+        callbacks_.erase(pattern);
+        for (auto it = globCallbacks_.begin(); it != globCallbacks_.end(); ++it) {
+            if (it->first == pattern) {
+                globCallbacks_.erase(it);
+                break;
+            }
+        }
+    }
+
+    // Matches a path against a glob with * (any sequence of characters, including /) and ? (any one character)
+    static bool GlobMatches(const std::string& glob, const std::string& path) {
+        size_t g = 0, p = 0, starG = std::string::npos, starP = 0;
+        while (p < path.size()) {
+            if (g < glob.size() && (glob[g] == '?' || glob[g] == path[p])) {
+                ++g;
+                ++p;
+            } else if (g < glob.size() && glob[g] == '*') {
+                starG = g++;
+                starP = p;
+            } else if (starG != std::string::npos) {
+                g = starG + 1;
+                p = ++starP;
+            } else {
+                return false;
+            }
+        }
+        while (g < glob.size() && glob[g] == '*')
+            ++g;
+        return g == glob.size();
     }
 
 private:
-    // Continuously watches for file changes
+    // Continuously polls for file changes (fallback)
     void WatchLoop() {
         std::unordered_map<std::string, std::filesystem::file_time_type> currentFiles;
+        bool firstScan = true;
+        SeedHashes();
 
         while (running_) {
-            std::this_thread::sleep_for(delay_);
-
             std::unordered_map<std::string, std::filesystem::file_time_type> newFiles;
-            for (const auto& entry : std::filesystem::directory_iterator(path_)) {
-                if (entry.is_regular_file()) {
-                    const auto& path = entry.path().string();
-                    newFiles[path] = std::filesystem::last_write_time(entry);
-                    if (currentFiles.find(path) == currentFiles.end() || currentFiles[path] != newFiles[path]) {
+            std::error_code error;
+            for (std::filesystem::recursive_directory_iterator it(path_, error), end; !error && it != end; it.increment(error)) {
+                if (it->is_regular_file(error)) {
+                    const auto& path = it->path().string();
+                    newFiles[path] = std::filesystem::last_write_time(*it, error);
+                    auto previous = currentFiles.find(path);
+                    if (!firstScan && (previous == currentFiles.end() || previous->second != newFiles[path])) {
                         NotifyFileChanged(path);
                     }
                 }
             }
 
-            currentFiles = newFiles;
+            currentFiles = std::move(newFiles);
+            firstScan = false;
+            std::this_thread::sleep_for(delay_);
         }
     }
 
+#if defined(__linux__)
+    // Waits for inotify events. Returns false if inotify could not be set up or failed while waiting, so the caller can
+    // fall back to polling.
+    bool WatchLoopInotify() {
+        if (wakeFd_ < 0)
+            return false;
+        const int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0)
+            return false;
+
+        std::unordered_map<int, std::string> watchedDirectories;     // Watch descriptor -> directory
+        auto addWatch = [&](const std::string& directory) {
+            const int wd = inotify_add_watch(inotifyFd, directory.c_str(),
+                                             IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE
+                                             | IN_MODIFY | IN_DELETE_SELF);
+            if (wd >= 0)
+                watchedDirectories[wd] = directory;
+        };
+        auto addWatchesRecursively = [&](const std::string& root) {
+            addWatch(root);
+            std::error_code error;
+            for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error))
+                if (it->is_directory(error))
+                    addWatch(it->path().string());
+        };
+        // Drops the watches of a directory that was moved away or deleted, and of its subdirectories
+        auto removeWatchesRecursively = [&](const std::string& root) {
+            for (auto it = watchedDirectories.begin(); it != watchedDirectories.end();) {
+                if (it->second == root || it->second.compare(0, root.size() + 1, root + "/") == 0) {
+                    inotify_rm_watch(inotifyFd, it->first);
+                    it = watchedDirectories.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        };
+        addWatchesRecursively(path_);
+        if (watchedDirectories.empty()) {
+            close(inotifyFd);
+            return false;
+        }
+        SeedHashes();
+
+        // Changed files of the current burst, reported once the directory has been quiet for coalesce_ (or once the
+        // burst is maxDelay_ old)
+        std::set<std::string> pendingFiles;
+        auto lastEvent = std::chrono::steady_clock::now();
+        auto firstPendingEvent = lastEvent;
+        auto addPending = [&](const std::string& file) {
+            if (pendingFiles.empty())
+                firstPendingEvent = std::chrono::steady_clock::now();
+            pendingFiles.insert(file);
+        };
+        alignas(inotify_event) char buffer[16 * 1024];
+
+        while (running_) {
+            pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { wakeFd_, POLLIN, 0 } };
+            int timeout = -1;
+            if (!pendingFiles.empty()) {
+                const auto now = std::chrono::steady_clock::now();
+                const auto flushAt = std::min(lastEvent + coalesce_, firstPendingEvent + maxDelay_);
+                timeout = std::max(0, static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(flushAt - now).count()));
+            }
+            const int ready = poll(fds, 2, timeout);
+            if (ready < 0 && errno != EINTR) {
+                // Hot reload must keep working: report what is pending and let the caller fall back to polling
+                const int error = errno;
+                std::fprintf(stderr, "FileWatcher: poll() failed (%s), falling back to polling\n", std::strerror(error));
+                for (const auto& file : pendingFiles)
+                    NotifyFileChanged(file);
+                close(inotifyFd);
+                return false;
+            }
+
+            if (ready > 0 && (fds[0].revents & POLLIN)) {
+                ssize_t length;
+                while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                    for (char* p = buffer; p < buffer + length;) {
+                        const auto* event = reinterpret_cast<const inotify_event*>(p);
+                        p += sizeof(inotify_event) + event->len;
+                        lastEvent = std::chrono::steady_clock::now();
+                        if (event->mask & IN_Q_OVERFLOW) {
+                            // Events were dropped: watch directories that may have been missed and check every file
+                            // (known or on disk) against its hash, NotifyFileChanged() then re-seeds the changed ones
+                            addWatchesRecursively(path_);
+                            for (const auto& file : ListFiles())
+                                addPending(file);
+                            continue;
+                        }
+                        auto directory = watchedDirectories.find(event->wd);
+                        if (directory == watchedDirectories.end())
+                            continue;
+                        if (event->mask & (IN_IGNORED | IN_DELETE_SELF)) {
+                            // The directory itself is gone (or its watch was removed)
+                            watchedDirectories.erase(directory);
+                            continue;
+                        }
+                        if (event->len == 0)
+                            continue;
+                        const std::string path = directory->second + "/" + event->name;
+                        if (event->mask & IN_ISDIR) {
+                            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                                // Watch new subdirectories too (and report files that were created in them already)
+                                addWatchesRecursively(path);
+                                std::error_code error;
+                                for (std::filesystem::recursive_directory_iterator it(path, error), end; !error && it != end; it.increment(error))
+                                    if (it->is_regular_file(error))
+                                        addPending(it->path().string());
+                            } else if (event->mask & (IN_MOVED_FROM | IN_DELETE)) {
+                                // The files that were in it are gone
+                                removeWatchesRecursively(path);
+                                for (const auto& file : hashes_)
+                                    if (file.first.compare(0, path.size() + 1, path + "/") == 0)
+                                        addPending(file.first);
+                            }
+                        } else {
+                            addPending(path);
+                        }
+                    }
+                }
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (!pendingFiles.empty() && (now - lastEvent >= coalesce_ || now - firstPendingEvent >= maxDelay_)) {
+                for (const auto& file : pendingFiles)
+                    NotifyFileChanged(file);
+                pendingFiles.clear();
+            }
+        }
+
+        close(inotifyFd);
+        return true;
+    }
+#endif
+
+    static bool IsGlob(const std::string& pattern) {
+        return pattern.find_first_of("*?") != std::string::npos;
+    }
+
+    // FNV-1a hash of the file contents. Returns false if the file can't be read (e.g. it was deleted).
+    static bool HashFile(const std::string& path, uint64_t& hash) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        hash = 14695981039346656037ull;
+        char buffer[64 * 1024];
+        while (file) {
+            file.read(buffer, sizeof(buffer));
+            for (std::streamsize i = 0; i < file.gcount(); ++i) {
+                hash ^= static_cast<unsigned char>(buffer[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+        return true;
+    }
+
+    // All files on disk and all files seen before (which may have been deleted since)
+    std::set<std::string> ListFiles() const {
+        std::set<std::string> files;
+        for (const auto& file : hashes_)
+            files.insert(file.first);
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator it(path_, error), end; !error && it != end; it.increment(error))
+            if (it->is_regular_file(error))
+                files.insert(it->path().string());
+        return files;
+    }
+
+    // Remembers the hashes of all files, so the first change can be compared against them
+    void SeedHashes() {
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator it(path_, error), end; !error && it != end; it.increment(error)) {
+            uint64_t hash;
+            if (it->is_regular_file(error) && HashFile(it->path().string(), hash))
+                hashes_[it->path().string()] = hash;
+        }
+    }
+
+    // True if the contents of the file changed since it was last seen (or it was created or deleted)
+    bool ContentChanged(const std::string& filename) {
+        uint64_t hash;
+        if (!HashFile(filename, hash))
+            return hashes_.erase(filename) > 0;
+        auto previous = hashes_.find(filename);
+        if (previous != hashes_.end() && previous->second == hash)
+            return false;
+        hashes_[filename] = hash;
+        return true;
+    }
+
     // Notifies the registered callbacks about a file change
     void NotifyFileChanged(const std::string& filename) {
-        for (const auto& callback : callbacks_) {
-            if (filename.find(callback.first) != std::string::npos) {
-                callback.second(filename);
+        if (!ContentChanged(filename))
+            return;
+
+        const auto relativePath = std::filesystem::path(filename).lexically_relative(path_).generic_string();
+        const auto name = std::filesystem::path(filename).filename().string();
+
+        // Copy the matching callbacks, so they can (un)register callbacks themselves without deadlocking
+        std::vector<Callback> matching;
+        {
+            std::lock_guard<std::mutex> lock(callbacksMutex_);
+            auto exact = callbacks_.find(relativePath);
+            if (exact != callbacks_.end())
+                matching.push_back(exact->second);
+            if (name != relativePath && (exact = callbacks_.find(name)) != callbacks_.end())
+                matching.push_back(exact->second);
+            for (const auto& glob : globCallbacks_) {
+                if (GlobMatches(glob.first, relativePath)) {
+                    matching.push_back(glob.second);
+                }
             }
         }
+        for (const auto& callback : matching) {
+            callback(filename);
+        }
     }
 
     std::string path_;                                      // The path to watch for file changes
-    std::chrono::duration<int, std::milli> delay_;          // The delay between checks for file changes
-    std::unordered_map<std::string, Callback> callbacks_;   // Mapping of filenames to callback functions
+    std::chrono::duration<int, std::milli> delay_;          // The delay between checks for file changes (polling)
+    std::chrono::duration<int, std::milli> coalesce_;       // Quiet time after which a burst of changes is reported
+    std::chrono::duration<int, std::milli> maxDelay_;       // Longest time a change waits for the burst to end
+    std::mutex callbacksMutex_;                             // Guards callbacks_ (read on the watcher thread)
+    std::unordered_map<std::string, Callback> callbacks_;   // Mapping of exact paths/file names to callback functions
+    std::vector<std::pair<std::string, Callback>> globCallbacks_;  // Glob patterns and their callback functions
+    std::unordered_map<std::string, uint64_t> hashes_;      // Content hashes of all files (watcher thread only)
 
     std::thread thread_;                                    // The thread running the WatchLoop function
     std::atomic<bool> running_;                             // Flag indicating whether the watcher is running
+    int wakeFd_ = -1;                                       // eventfd that wakes the inotify loop on Stop() (Linux)
 };
@@ -16,12 +16,21 @@
 #include <JavaScriptCore/JSRetainPtr.h>
 #include <JavaScriptCore/JavaScript.h>
 
-#include "FileWatcher.hpp"
+#include "HotReload.h"
+#include "HotReloadRouter.h"
+#include "IdleGarbageCollector.h"
+#include "InputEventQueue.h"
+#include "InputLatencyMeter.h"
+#include "InputTranslation.h"
 #include "JSInteropBase.h"
 #include "JSInteropExample.h"
+#include "MemoryAccounting.h"
+#include "OpenGLPresenter.h"
 #include "ULHelper.h"
 #include "Ultralight/RefPtr.h"
 #include "PluginProcessor.h"
+#include "SharedResourceCache.h"
+#include "TraceEvents.h"
 #include "InspectorModalWindow.h"
 #include "ULHelper.h"
 #include "Config.h"
@@ -32,6 +41,84 @@ using namespace ultralight;
 static int WIDTH = 1024;
 static int HEIGHT = 700;
 
+// How often the audio load readout in the web UI is updated (in frames of the 60 Hz timer)
+static const int AUDIO_LOAD_UPDATE_INTERVAL_FRAMES = 15;
+// How often a hidden editor checks whether it became visible again (nothing is rendered meanwhile)
+static const int HIDDEN_VISIBILITY_CHECK_HZ = 4;
+// How often the files used by the page are reported to the hot-reload router (in frames of the 60 Hz timer)
+static const int DEPENDENCY_UPDATE_INTERVAL_FRAMES = 120;
+// How often memory usage is sampled and sent to the web UI (in frames of the 60 Hz timer)
+static const int MEMORY_SAMPLE_INTERVAL_FRAMES = 300;
+
+// Audio load statistics are sent to JS as plain object, see AudioLoadUpdate() in Resources/script.js
+template<>
+struct JSStructFields<AudioLoadMeter::Stats> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("currentLoad", &AudioLoadMeter::Stats::currentLoad),
+            jsField("meanLoad", &AudioLoadMeter::Stats::meanLoad),
+            jsField("maxLoad", &AudioLoadMeter::Stats::maxLoad),
+            jsField("p50Load", &AudioLoadMeter::Stats::p50Load),
+            jsField("p95Load", &AudioLoadMeter::Stats::p95Load),
+            jsField("p99Load", &AudioLoadMeter::Stats::p99Load),
+            jsField("budgetMs", &AudioLoadMeter::Stats::budgetMs),
+            jsField("maxBlockMs", &AudioLoadMeter::Stats::maxBlockMs),
+            jsField("blocks", &AudioLoadMeter::Stats::blocks),
+            jsField("deadlineMisses", &AudioLoadMeter::Stats::deadlineMisses));
+};
+
+// Input latency statistics, see InputLatencyUpdate() in Resources/script.js
+template<>
+struct JSStructFields<InputLatencyMeter::Stats> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("p50Ms", &InputLatencyMeter::Stats::p50Ms),
+            jsField("p95Ms", &InputLatencyMeter::Stats::p95Ms),
+            jsField("p99Ms", &InputLatencyMeter::Stats::p99Ms),
+            jsField("maxMs", &InputLatencyMeter::Stats::maxMs),
+            jsField("meanMs", &InputLatencyMeter::Stats::meanMs),
+            jsField("frames", &InputLatencyMeter::Stats::frames),
+            jsField("dropped", &InputLatencyMeter::Stats::dropped),
+            jsField("handledP50Ms", &InputLatencyMeter::Stats::handledP50Ms),
+            jsField("handledP99Ms", &InputLatencyMeter::Stats::handledP99Ms),
+            jsField("handled", &InputLatencyMeter::Stats::handled));
+};
+
+// Frame times and idle garbage collections, see FrameTimeUpdate() in Resources/script.js
+template<>
+struct JSStructFields<IdleGarbageCollector::Stats> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("interactionP50Ms", &IdleGarbageCollector::Stats::interactionP50Ms),
+            jsField("interactionP99Ms", &IdleGarbageCollector::Stats::interactionP99Ms),
+            jsField("interactionMaxMs", &IdleGarbageCollector::Stats::interactionMaxMs),
+            jsField("interactionFrames", &IdleGarbageCollector::Stats::interactionFrames),
+            jsField("collections", &IdleGarbageCollector::Stats::collections),
+            jsField("collectionP50Ms", &IdleGarbageCollector::Stats::collectionP50Ms),
+            jsField("collectionMaxMs", &IdleGarbageCollector::Stats::collectionMaxMs),
+            jsField("aggressiveness", &IdleGarbageCollector::Stats::aggressiveness));
+};
+
+// Memory usage samples, see MemoryUpdate() in Resources/script.js
+template<>
+struct JSStructFields<MemoryAccounting::Snapshot> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("timeSeconds", &MemoryAccounting::Snapshot::timeSeconds),
+            jsField("viewBitmapBytes", &MemoryAccounting::Snapshot::viewBitmapBytes),
+            jsField("inspectorBitmapBytes", &MemoryAccounting::Snapshot::inspectorBitmapBytes),
+            jsField("imageBytes", &MemoryAccounting::Snapshot::imageBytes),
+            jsField("inspectorImageBytes", &MemoryAccounting::Snapshot::inspectorImageBytes),
+            jsField("jsHeapAvailable", &MemoryAccounting::Snapshot::jsHeapAvailable),
+            jsField("jsHeapBytes", &MemoryAccounting::Snapshot::jsHeapBytes),
+            jsField("jsHeapCapacityBytes", &MemoryAccounting::Snapshot::jsHeapCapacityBytes),
+            jsField("jsExtraMemoryBytes", &MemoryAccounting::Snapshot::jsExtraMemoryBytes),
+            jsField("jsObjectCount", &MemoryAccounting::Snapshot::jsObjectCount),
+            jsField("interopStringsCreated", &MemoryAccounting::Snapshot::interopStringsCreated),
+            jsField("interopStringsReleased", &MemoryAccounting::Snapshot::interopStringsReleased),
+            jsField("interopFunctionWrappers", &MemoryAccounting::Snapshot::interopFunctionWrappers),
+            jsField("rendererViewBitmapBytes", &MemoryAccounting::Snapshot::rendererViewBitmapBytes),
+            jsField("rendererEstimatedBytes", &MemoryAccounting::Snapshot::rendererEstimatedBytes),
+            jsField("processResidentBytes", &MemoryAccounting::Snapshot::processResidentBytes),
+            jsField("rendererViews", &MemoryAccounting::Snapshot::rendererViews));
+};
+
 class GUIMainComponent :
         public juce::Component,
         public juce::AudioProcessorValueTreeState::Listener,
@@ -39,7 +126,8 @@ class GUIMainComponent :
         public juce::KeyListener,
         public ultralight::LoadListener {
 public:
-    GUIMainComponent(juce::AudioProcessorValueTreeState &params) : audioParams(params) {
+    GUIMainComponent(juce::AudioProcessorValueTreeState &params)
+    : audioParams(params), processor(dynamic_cast<AudioPluginAudioProcessor&>(params.processor)) {
         // ================================== JUCE ========================================
         // Set component size
         setSize(WIDTH, HEIGHT);
@@ -49,7 +137,9 @@ public:
 
         // Get the scale parameter of the main monitor.
         // If you use multiple screens with different DPIs, you need to handle the scaling transitions.
-        auto scale = juce::Desktop::getInstance().getDisplays().displays[0].scale;
+        // Fall back to 1.0 if no display is connected.
+        const auto* display = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay();
+        auto scale = display != nullptr ? display->scale : 1.0;
         JUCE_SCALE = scale;
         DBG("Current monitor scale: " << scale);
 
@@ -61,44 +151,57 @@ public:
         // of the View will be transparent. This allows you to overlay the View on top of other JUCE components.
         // If you want an opaque background, set this to false.
         // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-        view = AudioPluginAudioProcessor::RENDERER->CreateView(
+        view = AudioPluginAudioProcessor::getRenderer()->CreateView(
                 static_cast<uint32_t>(WIDTH * JUCE_SCALE),
                 static_cast<uint32_t>(HEIGHT * JUCE_SCALE),
                 true, // Transparent background
-                nullptr);
+                AudioPluginAudioProcessor::getSession().get()); // Shared by all views, so they share Ultralight's caches
         // Create JS inspector View
         inspectorView = view->inspector();
         inspectorView->Resize(static_cast<uint32_t>(WIDTH * JUCE_SCALE), 500);
 
+        // Let the memory manager account for our views and purge the renderer's caches once the last editor closes
+        auto& memoryManager = AudioPluginAudioProcessor::getRendererMemoryManager();
+        memoryManager.editorOpened();
+        memoryManager.addView(view.get());
+        memoryManager.addView(inspectorView.get());
+
         // Set up JS interop for main View
         jsInterop = std::make_unique<JSInteropExample>(*view, audioParams, *this);
         // Tell ultralight that for this view, we want to use this JSInteropExample instance to handle the interop
         // Look into JSInteropExample.h for more info on JS interop
         view->set_load_listener(jsInterop.get());
-
-        // Load HTML file from URL - this URL is relative to the resources folder set in
-        // the createPluginFilter() method in PluginProcessor.cpp
+        // The page marks when it handled an input event (see InputLatencyMeter.h)
+        jsInterop->onInputHandled = [this]() {
+            inputLatency.markHandled();
+            idleGC.inputHandled();
+        };
+        // The page's ParameterMirror also carries the host transport
+        jsInterop->getParameterMirror().setTransport(&processor.getHostTransport());
+
+        // Load HTML file from URL - this URL is resolved by the file system set in
+        // AudioPluginAudioProcessor::setUpUltralightPlatform() in PluginProcessor.cpp
         view->LoadURL("file:///index.html");
 
         // Notify the View it has input focus (updates appearance)
         view->Focus();
 
+        // Present through OpenGL instead of juce::Graphics if enabled (see OpenGLPresenter.h and Config.h)
+        if (USE_OPENGL_PRESENTER)
+            openGLPresenter = std::make_unique<OpenGLPresenter>(*this);
+
         // ================================== MISCELLANEOUS ==================================
-        // Add file watcher to watch for changes to index.html and automatically hot-reload the View when
-        // files (e.g., HTML, JS, CSS) in the given folder are changed
-        fileWatcher = std::make_unique<FileWatcher>(JS_RESOURCES_PATH);
-        // Describe which files you want to watch
-        fileWatcher->AddCallback("index.html", [this](const std::string &filename) {
-            DBG("File changed: " << filename);
+#if ULTRALIGHTJUCE_LOOSE_RESOURCES
+        // Subscribe to changes of the files (e.g., HTML, JS, CSS) in the given folder to automatically hot-reload
+        // the View. The process-wide router only passes on changes of files this View actually uses.
+        // Only with loose resources, embedded resources can't change at runtime.
+        hotReloadSubscription = HotReloadRouter::getInstance().subscribe(JS_RESOURCES_PATH,
+                                                                         [this](const std::string &relativePath) {
+            DBG("File changed: " << relativePath);
             // Adding a filename to this queue will enable hot-reloading when the file is changed
-            fileWatcherQueue.enqueue(filename);
-        });
-        fileWatcher->AddCallback("script.js", [this](const std::string &filename) {
-            DBG("File changed: " << filename);
-            fileWatcherQueue.enqueue(filename);
+            fileWatcherQueue.enqueue(relativePath);
         });
-        // Start watching the files
-        fileWatcher->Start();
+#endif
 
         // Listen to keyboard presses
         addKeyListener(this);
@@ -109,60 +212,141 @@ public:
         startTimerHz(60);
     }
 
-    /// \brief Paint method called by JUCE
+    /// \brief Paint method called by JUCE (not used while the OpenGL presenter is attached)
     /// \param g JUCE Graphics context
     /// Here we draw all our JUCE components and Ultralight views
     void paint(juce::Graphics &g) override {
+        ULJ_TRACE_SCOPE("paint");
+        const double frameStart = juce::Time::getMillisecondCounterHiRes();
         g.fillAll(juce::Colours::black);
 
         // ================================== JUCE ========================================
         // This is where you can draw all your juce components (this project currently uses only Ultralight Views)
 
         // ================================== ULTRALIGHT ==================================
+        // Hidden (e.g. painted for a snapshot while minimised): show the last frame, don't render
+        const bool surfaceChanged = !renderingPaused && renderFrame();
+
+        // Draw the image we just got from Ultralight to the screen.
+        {
+            ULJ_TRACE_SCOPE("drawImage");
+            g.drawImage(image,
+                        0, 0, WIDTH, HEIGHT,
+                        0, 0, static_cast<int>(WIDTH * JUCE_SCALE), static_cast<int>(HEIGHT * JUCE_SCALE));
+        }
+        // The input that caused new pixels is now on screen (as far as we can tell)
+        inputLatency.framePresented(surfaceChanged);
+        if (!renderingPaused)
+            idleGC.frameFinished(juce::Time::getMillisecondCounterHiRes() - frameStart, surfaceChanged);
+    }
+
+    /// \brief Hands queued input and file changes to the View, updates the renderer and takes the new pixels of our
+    /// View (into `image`, or into the OpenGL presenter's texture). Message thread only, like all Ultralight calls.
+    /// \return true if the View's surface changed
+    bool renderFrame() {
+        ULJ_TRACE_SCOPE("renderFrame");
         std::string out;
+        bool needsReload = false;
         while (fileWatcherQueue.try_dequeue(out)) {
-            // TODO: If multiple views, keep a map of files and their views
+            ULJ_TRACE_SCOPE_DETAIL("HotReload::applyInPlace", out.c_str());
+            // Stylesheets and images are swapped in place (keeps the DOM and JS state), anything else reloads the page
+            // (once, no matter how many files changed)
+            if (!needsReload && !HotReload::applyInPlace(*view, out))
+                needsReload = true;
+        }
+        if (needsReload) {
+            ULJ_TRACE_SCOPE("View::Reload");
             view->Reload();
+            framesSinceDependencyUpdate = DEPENDENCY_UPDATE_INTERVAL_FRAMES;
+        }
+
+        // Hand the (coalesced) input of this frame to the View
+        {
+            ULJ_TRACE_SCOPE("Input flush");
+            inputLatency.inputsFlushed();
+            inputQueue.flush(*view);
+        }
+
+        // Parameter values and transport for this frame's requestAnimationFrame() callbacks (see ParameterMirror.h)
+        {
+            ULJ_TRACE_SCOPE("ParameterMirror::snapshot");
+            jsInterop->getParameterMirror().snapshot();
         }
 
         // Update and render all active Ultralight Views (this updates the Surface for each View).
-        AudioPluginAudioProcessor::RENDERER->Update();
-        AudioPluginAudioProcessor::RENDERER->Render();
+        {
+            ULJ_TRACE_SCOPE("Renderer::Update");
+            AudioPluginAudioProcessor::getRenderer()->Update();
+        }
+        {
+            ULJ_TRACE_SCOPE("Renderer::Render");
+            AudioPluginAudioProcessor::getRenderer()->Render();
+        }
 
         // Get the Surface as a BitmapSurface (the default implementation).
         auto *surface = (BitmapSurface *) (view->surface());
 
         // Check if our Surface is dirty (pixels have changed).
-        if (!surface->dirty_bounds().IsEmpty()) {
-            // Get the pixel-buffer Surface for a View.
-            RefPtr<Bitmap> bitmap = surface->bitmap();
-            // Lock the Bitmap to retrieve the raw pixels.
-            // The format is ARGB, 4-bpp, premultiplied alpha.
-            void *pixels = bitmap->LockPixels();
-            // Get the bitmap dimensions.
-            uint32_t width = bitmap->width();
-            uint32_t height = bitmap->height();
-            uint32_t stride = bitmap->row_bytes();
+        const auto dirty = surface->dirty_bounds();
+        if (dirty.IsEmpty())
+            return false;
+
+        ULJ_TRACE_SCOPE("Copy pixels");
+        // Get the pixel-buffer Surface for a View.
+        RefPtr<Bitmap> bitmap = surface->bitmap();
+        // Lock the Bitmap to retrieve the raw pixels.
+        // The format is BGRA, 4-bpp, premultiplied alpha.
+        void *pixels = bitmap->LockPixels();
+        // Get the bitmap dimensions.
+        uint32_t width = bitmap->width();
+        uint32_t height = bitmap->height();
+        uint32_t stride = bitmap->row_bytes();
+        if (openGLPresenter != nullptr) {
+            // Only the dirty part is copied and streamed into the presenter's texture
+            openGLPresenter->upload(pixels, width, height, stride,
+                                    juce::Rectangle<int>::leftTopRightBottom(dirty.left, dirty.top, dirty.right, dirty.bottom));
+        } else {
             // Copy the raw pixels into a JUCE Image.
             image = ULHelper::CopyPixelsToTexture(pixels, width, height, stride);
+        }
 
-            // Spawn inspector if it doesn't exist
-            if (inspectorModalWindow == nullptr) {
-                inspectorModalWindow = std::make_unique<InspectorModalWindow>(inspectorView, inspectorImage,
-                                                                              JUCE_SCALE);
-                // Hide inspector initially
-                inspectorModalWindow->setVisible(false);
-            }
-
-            // Unlock the Bitmap and mark the Surface as clean.
-            bitmap->UnlockPixels();
-            surface->ClearDirtyBounds();
+        // Spawn inspector if it doesn't exist
+        if (inspectorModalWindow == nullptr) {
+            inspectorModalWindow = std::make_unique<InspectorModalWindow>(inspectorView, inspectorImage,
+                                                                          JUCE_SCALE);
+            // Hide inspector initially
+            inspectorModalWindow->setVisible(false);
         }
 
-        // Draw the image we just got from Ultralight to the screen.
-        g.drawImage(image,
-                    0, 0, WIDTH, HEIGHT,
-                    0, 0, static_cast<int>(WIDTH * JUCE_SCALE), static_cast<int>(HEIGHT * JUCE_SCALE));
+        // Unlock the Bitmap and mark the Surface as clean.
+        bitmap->UnlockPixels();
+        surface->ClearDirtyBounds();
+        return true;
+    }
+
+    /// \brief Requests a frame: a repaint in software, an asynchronous renderFrame() with the OpenGL presenter (its
+    /// component painting is disabled, and Ultralight can't be called from the GL thread)
+    void requestFrame() {
+        if (openGLPresenter == nullptr) {
+            repaint();
+            return;
+        }
+        if (frameRequested)
+            return;
+        frameRequested = true;
+        juce::Component::SafePointer<GUIMainComponent> safeThis(this);
+        juce::MessageManager::callAsync([safeThis]() {
+            if (safeThis == nullptr)
+                return;
+            safeThis->frameRequested = false;
+            if (safeThis->openGLPresenter == nullptr || safeThis->renderingPaused)
+                return;
+            // Approximation: the frame is drawn by the GL thread shortly after
+            const double frameStart = juce::Time::getMillisecondCounterHiRes();
+            const bool surfaceChanged = safeThis->renderFrame();
+            safeThis->inputLatency.framePresented(surfaceChanged);
+            safeThis->idleGC.frameFinished(juce::Time::getMillisecondCounterHiRes() - frameStart, surfaceChanged);
+        });
     }
 
     /// \brief Called when the JUCE window is resized.
@@ -187,59 +371,102 @@ public:
     }
 
     // ================================== Mouse events ==================================
+    // All input is queued (see InputEventQueue.h), the View gets it right before the next Renderer::Update()
     void mouseMove(const juce::MouseEvent &event) override {
 //        DBG("Mouse moved: " << event.x << ", " << event.y);
-        MouseEvent evt{};
-        evt.type = MouseEvent::kType_MouseMoved;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = MouseEvent::kButton_None;
-        view->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(MouseEvent::kType_MouseMoved, event));
     }
 
     void mouseDown(const juce::MouseEvent &event) override {
         DBG("Mouse down: " << event.x << ", " << event.y);
-        MouseEvent evt{};
-        evt.type = MouseEvent::kType_MouseDown;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? MouseEvent::kButton_Left : MouseEvent::kButton_Right;
-        view->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(MouseEvent::kType_MouseDown, event));
     }
 
     void mouseDrag(const juce::MouseEvent &event) override {
 //        DBG("Mouse drag: " << event.x << ", " << event.y);
-        MouseEvent evt{};
-        evt.type = MouseEvent::kType_MouseMoved;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? MouseEvent::kButton_Left : MouseEvent::kButton_Right;
-        view->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(MouseEvent::kType_MouseMoved, event));
     }
 
     void mouseUp(const juce::MouseEvent &event) override {
         DBG("Mouse up: " << event.x << ", " << event.y);
-        MouseEvent evt{};
-        evt.type = MouseEvent::kType_MouseUp;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? MouseEvent::kButton_Left : MouseEvent::kButton_Right;
-        view->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(MouseEvent::kType_MouseUp, event));
+    }
+
+    void mouseWheelMove(const juce::MouseEvent &event, const juce::MouseWheelDetails &wheel) override {
+        juce::ignoreUnused(event);
+        queueInput(InputTranslation::toScrollEvent(wheel));
     }
 
     /// \brief JUCE Timer callback
     /// We use it to periodically repaint the window and the inspector window if it is open
     void timerCallback() override {
-        repaint();
+        updateVisibility();
+        // A hidden page gets the latest state once it becomes visible again, the flag stays set until then
+        if (renderingPaused)
+            return;
+
+        if (apvtsPushPending.exchange(false, std::memory_order_acquire))
+            jsInterop->pushAPVTSState();
+
+        // Fall back to software presentation if OpenGL isn't usable
+        if (openGLPresenter != nullptr && openGLPresenter->hasFailed()) {
+            DBG("OpenGL presentation failed, falling back to software");
+            openGLPresenter.reset();
+            view->set_needs_paint(true);
+        }
+
+        requestFrame();
         if (inspectorModalWindow != nullptr && inspectorModalWindow->isActiveWindow()) {
             inspectorModalWindow->repaint();
         }
+
+        // Live readout of the audio thread load, so the effect of UI activity on audio performance is visible
+        if (++framesSinceAudioLoadUpdate >= AUDIO_LOAD_UPDATE_INTERVAL_FRAMES && jsInterop->isDOMReady()) {
+            framesSinceAudioLoadUpdate = 0;
+            jsInterop->invokeMethod("AudioLoadUpdate", processor.getAudioLoadStats());
+            jsInterop->invokeMethod("InputLatencyUpdate", inputLatency.getStats());
+            jsInterop->invokeMethod("FrameTimeUpdate", idleGC.getStats());
+        }
+
+        // Collect JS garbage now that nothing happens, rather than in the middle of the next interaction
+        if (idleGC.shouldCollect())
+            collectGarbage();
+
+        // Memory usage over time, so leaks show up as trends (the history is also available from C++)
+        if (++framesSinceMemorySample >= MEMORY_SAMPLE_INTERVAL_FRAMES && jsInterop->isDOMReady()) {
+            framesSinceMemorySample = 0;
+            jsInterop->invokeMethod("MemoryUpdate", sampleMemory());
+        }
+
+        // Tell the hot-reload router which files the page uses (again from time to time, pages can load more later)
+        if (hotReloadSubscription >= 0 && ++framesSinceDependencyUpdate >= DEPENDENCY_UPDATE_INTERVAL_FRAMES
+            && jsInterop->isDOMReady()) {
+            framesSinceDependencyUpdate = 0;
+            auto dependencies = juce::JSON::parse(juce::String(view->EvaluateScript(HotReloadRouter::getDependencyScript()).utf8().data()));
+            juce::StringArray urls;
+            if (auto* array = dependencies.getArray())
+                for (const auto& url : *array)
+                    urls.add(url.toString());
+            HotReloadRouter::getInstance().setDependencies(hotReloadSubscription, urls);
+        }
     }
 
+    /// \brief Collects the garbage of the page's JS context (see IdleGarbageCollector.h)
+    void collectGarbage() {
+        ULJ_TRACE_SCOPE("JSGarbageCollect");
+        Ref<JSContext> context = view->LockJSContext();
+        idleGC.collect(context.get());
+    }
+
+    /// \brief Samples the memory used by this editor, its page and the renderer (see MemoryAccounting.h)
+    MemoryAccounting::Snapshot sampleMemory() {
+        return memoryAccounting.sample(*view.get(), inspectorView.get(), image, inspectorImage,
+                                       AudioPluginAudioProcessor::getRendererMemoryManager());
+    }
+
+    /// \brief The last MemoryAccounting::HISTORY_LENGTH memory samples, oldest first
+    const std::deque<MemoryAccounting::Snapshot>& getMemoryHistory() const { return memoryAccounting.getHistory(); }
+
     /// \brief JUCE AudioProcessorValueTreeState::Listener callback
     /// \param parameterID The ID of the parameter that changed
     /// \param newValue The new value of the parameter
@@ -247,21 +474,25 @@ public:
     /// parameters in JS, but can just use the APVTS XML and let JS decide which parameters it wants to use.
     /// Change this method if you want to send individual parameters to JS.
     void parameterChanged(const juce::String &parameterID, float newValue) override {
-        if (!view.get())
+        ULJ_TRACE_SCOPE_DETAIL("parameterChanged", parameterID.toRawUTF8());
+        // Pages that read the ParameterMirror don't need the XML
+        if (!view.get() || jsInterop == nullptr || !jsInterop->isAPVTSPushEnabled())
             return;
 
         // Get the APVTS as XML string
-        // Important: execute on the JUCE Message thread
-        juce::MessageManager::callAsync([this]() {
-            juce::String xml = audioParams.copyState().createXml()->toString();
-            jsInterop->invokeMethod("APVTSUpdate", xml);
-        });
+        // Important: this is called on the audio thread for host automation, so only a flag is set here (no
+        // allocation, no message) and timerCallback() pushes on the Message thread. Changes that arrive before the
+        // push has run (e.g. all parameters of a restored state) share one push.
+        apvtsPushPending.store(true, std::memory_order_release);
     }
 
     // JUCE Key press event handler
     bool keyPressed(const juce::KeyPress &key, juce::Component *originatingComponent) override {
-        if (key.getTextCharacter() == 'i') {
-            // "I" key is pressed
+        AudioPluginAudioProcessor::getRendererMemoryManager().notifyActivity();
+        inputLatency.inputReceived();
+        idleGC.inputReceived();
+        // "I" toggles the inspector, unless the page is waiting for text (e.g. a text field has focus)
+        if (key.getTextCharacter() == 'i' && !view->HasInputFocus()) {
             // Hide/show inspector window
             if (inspectorModalWindow == nullptr) {
                 inspectorModalWindow = std::make_unique<InspectorModalWindow>(inspectorView, inspectorImage,
@@ -272,23 +503,103 @@ public:
             return true; // Return true to indicate that the key press is consumed
         }
 
-        return false; // Return false to allow the key press to propagate to other components
+        if (keyTranslation.keyPressed(key, inputQueue))
+            requestFrame();
+        // Only consume keys while the page takes text, so host shortcuts (e.g. space for play) keep working
+        return view->HasInputFocus();
+    }
+
+    // JUCE reports key releases only as state changes, InputTranslation finds out which keys were released
+    bool keyStateChanged(bool isKeyDown, juce::Component *originatingComponent) override {
+        if (keyTranslation.keyStateChanged(isKeyDown, inputQueue))
+            requestFrame();
+        return false;
     }
 
     ~GUIMainComponent() override {
         // Stop timer -> no more redraws
         stopTimer();
-        // Stop the file watcher
-        fileWatcher->Stop();
+        // Detach the OpenGL context while the component is still intact
+        openGLPresenter.reset();
+#if ULTRALIGHTJUCE_ENABLE_TRACING
+        // The editor closing ends a traced session
+        const auto traceFile = TraceEvents::getDefaultTraceFile();
+        if (TraceEvents::writeChromeJson(traceFile))
+            DBG("Trace written to " << traceFile.getFullPathName());
+#endif
+        // Stop listening to file changes
+        if (hotReloadSubscription >= 0)
+            HotReloadRouter::getInstance().unsubscribe(hotReloadSubscription);
         // Remove the load listener - removing this listener is important to avoid a crash on shutdown
         view->set_load_listener(nullptr);
         // Remove the APVTS parameter listener(s)
         audioParams.removeParameterListener("gain", this);
+        // Our views are released after this, the memory manager purges asynchronously once they are gone
+        auto& memoryManager = AudioPluginAudioProcessor::getRendererMemoryManager();
+        memoryManager.removeView(view.get());
+        memoryManager.removeView(inspectorView.get());
+        memoryManager.editorClosed();
+    }
+
+    // ================================== Visibility ==================================
+    void visibilityChanged() override {
+        updateVisibility();
+    }
+
+    void parentHierarchyChanged() override {
+        updateVisibility();
+    }
+
+    /// \brief True if any part of the editor can be seen: it and all its parents are visible, the window isn't
+    /// minimised and it isn't completely covered by parents or siblings. Other windows covering it aren't detected
+    /// (JUCE can't tell), neither are hosts that hide the plugin window without hiding or minimising it.
+    bool isOnScreen() {
+        if (!isShowing())
+            return false;
+        juce::RectangleList<int> visibleArea;
+        getVisibleArea(visibleArea, true);
+        return !visibleArea.isEmpty();
+    }
+
+    /// \brief Pauses rendering while the editor is hidden and catches up with a single frame once it is visible again
+    void updateVisibility() {
+        if (view.get() == nullptr || jsInterop == nullptr)
+            return;
+        const bool hidden = !isOnScreen();
+        if (hidden == renderingPaused)
+            return;
+        renderingPaused = hidden;
+        // Stops requestAnimationFrame() in the page, held back callbacks run in the catch-up frame
+        jsInterop->setPageHidden(hidden);
+        if (hidden) {
+            // No repaints, pixel copies or JS pushes anymore, just check now and then if we are back
+            startTimerHz(HIDDEN_VISIBILITY_CHECK_HZ);
+            // Nobody interacts with a hidden page, a good moment to collect
+            if (idleGC.shouldCollect(true))
+                collectGarbage();
+            return;
+        }
+
+        startTimerHz(60);
+        // The surface may be outdated (it's only copied while visible), so paint the whole view once
+        view->set_needs_paint(true);
+        requestFrame();
+    }
+
+    /// \brief Queues a mouse or scroll event for the next frame
+    template<typename Event>
+    void queueInput(const Event &event) {
+        AudioPluginAudioProcessor::getRendererMemoryManager().notifyActivity();
+        inputLatency.inputReceived();
+        idleGC.inputReceived();
+        if (inputQueue.push(event))
+            requestFrame();
     }
 
     // ================================== Fields ==================================
     // APVTS
     juce::AudioProcessorValueTreeState &audioParams;
+    AudioPluginAudioProcessor &processor;
 
     // Main view
     RefPtr<View> view;
@@ -296,20 +607,46 @@ public:
 
     // JS interop
     std::unique_ptr<JSInteropExample> jsInterop;
+    // Set by parameterChanged() (any thread), timerCallback() pushes the APVTS state to JS
+    std::atomic<bool> apvtsPushPending { false };
 
     // JUCE Image we render the ultralight UI to
     juce::Image image;
+    // Used instead of the image if USE_OPENGL_PRESENTER is set in Config.h
+    std::unique_ptr<OpenGLPresenter> openGLPresenter;
+    // True while a renderFrame() for the OpenGL presenter is queued on the Message thread
+    bool frameRequested = false;
     juce::Image inspectorImage;
 
-    // File watcher fields
-    std::unique_ptr<FileWatcher> fileWatcher;
+    // Hot-reload fields (changed files relative to the resources folder, see HotReloadRouter.h)
+    int hotReloadSubscription = -1;
     moodycamel::ReaderWriterQueue<std::string> fileWatcherQueue;
+    int framesSinceDependencyUpdate = 0;
+
+    // Input events since the last frame
+    InputEventQueue inputQueue;
+    // Keys currently held down (for key up events)
+    InputTranslation keyTranslation;
+    // Input-to-photon latency of the main view
+    InputLatencyMeter inputLatency;
+    // Frame times and JS garbage collection in idle periods
+    IdleGarbageCollector idleGC { IdleGarbageCollector::getDefaultSettings(
+            static_cast<IdleGarbageCollector::Aggressiveness>(IDLE_GC_AGGRESSIVENESS)) };
+    // Memory usage samples (see sampleMemory())
+    MemoryAccounting memoryAccounting;
+    int framesSinceMemorySample = 0;
 
     // Inspector window
     std::unique_ptr<InspectorModalWindow> inspectorModalWindow;
 
     // Scale multiplier from JUCE
     double JUCE_SCALE = 0;
+
+    // True while the editor is hidden (see updateVisibility())
+    bool renderingPaused = false;
+
+    // Frames since the audio load was last sent to JS
+    int framesSinceAudioLoadUpdate = 0;
 };
 
 
@@ -0,0 +1,83 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_HOSTTRANSPORT_H
+#define ULTRALIGHTJUCE_HOSTTRANSPORT_H
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+
+/// \brief The host's transport (tempo, position, play state) as seen by the last processBlock call, readable from the
+/// Message thread.
+///
+/// update() is called by the audio thread at the start of every block and only stores relaxed atomics, so it is
+/// wait-free and doesn't allocate. get() reads each value on its own: right at a block boundary, values from two
+/// consecutive blocks can be mixed, which is fine for display purposes. Values the host doesn't provide keep their
+/// last (or default) value.
+class HostTransport {
+public:
+    struct State {
+        double bpm = 120.0;
+        double ppqPosition = 0.0;           // Position in quarter notes
+        double timeSeconds = 0.0;
+        double barStartPpq = 0.0;           // Position of the current bar's start in quarter notes
+        int timeSigNumerator = 4;
+        int timeSigDenominator = 4;
+        bool playing = false;
+        bool recording = false;
+        bool looping = false;
+    };
+
+    /// \brief Audio thread, once per block
+    void update(juce::AudioPlayHead* playHead) noexcept {
+        if (playHead == nullptr)
+            return;
+        const auto position = playHead->getPosition();
+        if (!position.hasValue())
+            return;
+        if (const auto value = position->getBpm())
+            bpm.store(*value, std::memory_order_relaxed);
+        if (const auto value = position->getPpqPosition())
+            ppqPosition.store(*value, std::memory_order_relaxed);
+        if (const auto value = position->getTimeInSeconds())
+            timeSeconds.store(*value, std::memory_order_relaxed);
+        if (const auto value = position->getPpqPositionOfLastBarStart())
+            barStartPpq.store(*value, std::memory_order_relaxed);
+        if (const auto value = position->getTimeSignature()) {
+            timeSigNumerator.store(value->numerator, std::memory_order_relaxed);
+            timeSigDenominator.store(value->denominator, std::memory_order_relaxed);
+        }
+        playing.store(position->getIsPlaying(), std::memory_order_relaxed);
+        recording.store(position->getIsRecording(), std::memory_order_relaxed);
+        looping.store(position->getIsLooping(), std::memory_order_relaxed);
+    }
+
+    /// \brief Any thread
+    State get() const noexcept {
+        State state;
+        state.bpm = bpm.load(std::memory_order_relaxed);
+        state.ppqPosition = ppqPosition.load(std::memory_order_relaxed);
+        state.timeSeconds = timeSeconds.load(std::memory_order_relaxed);
+        state.barStartPpq = barStartPpq.load(std::memory_order_relaxed);
+        state.timeSigNumerator = timeSigNumerator.load(std::memory_order_relaxed);
+        state.timeSigDenominator = timeSigDenominator.load(std::memory_order_relaxed);
+        state.playing = playing.load(std::memory_order_relaxed);
+        state.recording = recording.load(std::memory_order_relaxed);
+        state.looping = looping.load(std::memory_order_relaxed);
+        return state;
+    }
+
+private:
+    std::atomic<double> bpm { 120.0 };
+    std::atomic<double> ppqPosition { 0.0 };
+    std::atomic<double> timeSeconds { 0.0 };
+    std::atomic<double> barStartPpq { 0.0 };
+    std::atomic<int> timeSigNumerator { 4 };
+    std::atomic<int> timeSigDenominator { 4 };
+    std::atomic<bool> playing { false };
+    std::atomic<bool> recording { false };
+    std::atomic<bool> looping { false };
+};
+
+#endif //ULTRALIGHTJUCE_HOSTTRANSPORT_H
@@ -0,0 +1,87 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_HOTRELOAD_H
+#define ULTRALIGHTJUCE_HOTRELOAD_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+
+/// \brief Applies changed resources to a running page without reloading it where possible.
+///
+/// A full View::Reload() throws away the DOM and all JS state and runs OnWindowObjectReady/OnDOMReady again
+/// (including the full parameter push). That's only needed when HTML or JS changed. Stylesheets and images are
+/// swapped in place instead: every <link rel="stylesheet">, <img> or inline style that refers to the changed file
+/// gets a cache-busting query appended, so Ultralight fetches it again (our file systems ignore the query).
+class HotReload {
+public:
+    enum class ChangeKind {
+        Stylesheet,
+        Image,
+        Page        // HTML, JS or anything unknown: needs a full reload
+    };
+
+    static ChangeKind classify(const juce::String& path) {
+        const auto extension = path.fromLastOccurrenceOf(".", false, false).toLowerCase();
+        if (extension == "css")
+            return ChangeKind::Stylesheet;
+        if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "gif"
+            || extension == "webp" || extension == "svg" || extension == "ico")
+            return ChangeKind::Image;
+        return ChangeKind::Page;
+    }
+
+    /// \brief Swaps the changed file in place.
+    /// \param relativePath Path of the file relative to the resources folder, with forward slashes
+    /// \return false if the page has to be reloaded instead (HTML/JS changed, or the page doesn't reference the file
+    /// in a way that can be swapped, e.g. an image used from a stylesheet)
+    static bool applyInPlace(ultralight::View& view, const juce::String& relativePath) {
+        const auto kind = classify(relativePath);
+        if (kind == ChangeKind::Page)
+            return false;
+
+        ultralight::String exception;
+        auto result = view.EvaluateScript(createSwapScript(relativePath, kind).toRawUTF8(), &exception);
+        if (!exception.empty()) {
+            DBG("HotReload: swapping " << relativePath << " failed: " << exception.utf8().data());
+            return false;
+        }
+        return juce::String(result.utf8().data()) == "true";
+    }
+
+private:
+    /// \brief Script that re-requests every reference to the file and evaluates to true if there was any
+    static juce::String createSwapScript(const juce::String& relativePath, ChangeKind kind) {
+        return juce::String(R"JS((function(changed, swapImages) {
+    const stamp = 'hotreload=' + Date.now();
+    // Resolves a reference to the path relative to the resources folder, null for anything remote
+    const relative = (url) => {
+        if (!url || /^(https?:|data:)/.test(url)) return null;
+        return url.split(/[?#]/)[0].replace(/^file:\/\/\//, '').replace(/^\.?\//, '');
+    };
+    const busted = (url) => url.split(/[?#]/)[0] + '?' + stamp;
+    let swapped = 0;
+    if (!swapImages) {
+        document.querySelectorAll('link[rel="stylesheet"]').forEach((link) => {
+            if (relative(link.getAttribute('href')) === changed) { link.href = busted(link.getAttribute('href')); ++swapped; }
+        });
+    } else {
+        document.querySelectorAll('img, [style*="url("]').forEach((element) => {
+            const src = element.getAttribute('src');
+            if (src && relative(src) === changed) { element.src = busted(src); ++swapped; }
+            const style = element.getAttribute('style');
+            if (style) {
+                const updated = style.replace(/url\((['"]?)([^'")]+)\1\)/g, (match, quote, url) =>
+                    relative(url) === changed ? 'url(' + quote + busted(url) + quote + ')' : match);
+                if (updated !== style) { element.setAttribute('style', updated); ++swapped; }
+            }
+        });
+    }
+    return swapped > 0;
+}))JS")
+               + "(" + juce::JSON::toString(relativePath) + ", " + (kind == ChangeKind::Image ? "true" : "false") + ")";
+    }
+};
+
+#endif //ULTRALIGHTJUCE_HOTRELOAD_H
@@ -0,0 +1,156 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_HOTRELOADROUTER_H
+#define ULTRALIGHTJUCE_HOTRELOADROUTER_H
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "FileWatcher.hpp"
+#include "PluginProcessor.h"
+#include "SharedResourceCache.h"
+#include "TraceEvents.h"
+
+/// \brief Routes file changes in the resources folder to the views that depend on the changed file.
+///
+/// There is one FileWatcher per process (running while at least one view is subscribed), instead of one per editor.
+/// Each view reports the files it uses (see getDependencyScript()), and only those views hear about a change.
+/// Views that haven't reported their dependencies yet get every change.
+///
+/// subscribe/unsubscribe/setDependencies must be called on the JUCE Message thread. Subscribers are called on the
+/// watcher thread with the path relative to the resources folder (forward slashes), so they should only queue it.
+class HotReloadRouter {
+public:
+    using Subscriber = std::function<void(const std::string& relativePath)>;
+
+    /// \brief The router of this process
+    static HotReloadRouter& getInstance() {
+        static HotReloadRouter router;
+        return router;
+    }
+
+    /// \brief Subscribes a view to changes. Starts watching if it is the first one.
+    /// \param resourcesPath Folder to watch (must be the same for all subscribers)
+    /// \return An id for unsubscribe() and setDependencies()
+    int subscribe(const std::string& resourcesPath, Subscriber subscriber) {
+        int id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = nextId++;
+            subscribers[id] = { std::move(subscriber), {}, false };
+        }
+        if (fileWatcher == nullptr) {
+            fileWatcher = std::make_unique<FileWatcher>(resourcesPath);
+            fileWatcher->AddCallback("*", [this, resourcesPath](const std::string& filename) {
+                route(std::filesystem::path(filename).lexically_relative(resourcesPath).generic_string());
+            });
+            fileWatcher->Start();
+        }
+        return id;
+    }
+
+    /// \brief Unsubscribes a view. Stops watching if it was the last one.
+    void unsubscribe(int id) {
+        bool empty;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            subscribers.erase(id);
+            empty = subscribers.empty();
+        }
+        if (empty && fileWatcher != nullptr) {
+            fileWatcher->Stop();
+            fileWatcher.reset();
+        }
+    }
+
+    /// \brief Sets the files a view depends on
+    /// \param urls URLs as the page uses them (e.g. "file:///img/knob.svg"), remote URLs are ignored
+    void setDependencies(int id, const juce::StringArray& urls) {
+        std::set<std::string> dependencies;
+        for (const auto& url : urls) {
+            if (url.startsWith("http:") || url.startsWith("https:") || url.startsWith("data:"))
+                continue;
+            auto path = url.upToFirstOccurrenceOf("?", false, false).upToFirstOccurrenceOf("#", false, false);
+            if (path.startsWith("file://"))
+                path = path.substring(7);
+            // The watcher reports plain paths, e.g. "img/my%20knob.svg" is "img/my knob.svg" on disk.
+            // removeEscapeChars() also turns '+' into a space, which is only right for query strings, so keep it.
+            path = juce::URL::removeEscapeChars(path.replace("+", "%2B"));
+            dependencies.insert(path.trimCharactersAtStart("/").toStdString());
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = subscribers.find(id);
+        if (it != subscribers.end()) {
+            it->second.dependencies = std::move(dependencies);
+            it->second.dependenciesKnown = true;
+        }
+    }
+
+    /// \brief Script that evaluates to a JSON array of all local files the page uses: the document itself,
+    /// stylesheets, scripts, images, and url() references in stylesheets (resolved against the stylesheet, like the
+    /// browser does) and inline styles (resolved against the document)
+    static const char* getDependencyScript() {
+        return R"JS((function() {
+    const urls = new Set([document.location.href]);
+    const addCssUrls = (text, base) => { for (const match of text.matchAll(/url\((['"]?)([^'")]+)\1\)/g)) urls.add(new URL(match[2], base).href); };
+    const addSheet = (sheet) => {
+        // Inline <style> sheets have no href of their own
+        const base = sheet.href || document.baseURI;
+        try {
+            for (const rule of sheet.cssRules) {
+                addCssUrls(rule.cssText, base);
+                if (rule.styleSheet) addSheet(rule.styleSheet);    // @import
+            }
+        } catch (e) { /* Not readable (remote) */ }
+    };
+    document.querySelectorAll('link[href]').forEach((e) => urls.add(e.href));
+    document.querySelectorAll('script[src]').forEach((e) => urls.add(e.src));
+    document.querySelectorAll('img[src]').forEach((e) => urls.add(e.src));
+    document.querySelectorAll('[style*="url("]').forEach((e) => addCssUrls(e.getAttribute('style'), document.baseURI));
+    for (const sheet of document.styleSheets) addSheet(sheet);
+    return JSON.stringify([...urls]);
+})())JS";
+    }
+
+private:
+    struct Subscription {
+        Subscriber subscriber;
+        std::set<std::string> dependencies;
+        bool dependenciesKnown = false;
+    };
+
+    HotReloadRouter() = default;
+
+    ~HotReloadRouter() {
+        if (fileWatcher != nullptr)
+            fileWatcher->Stop();
+    }
+
+    // Watcher thread
+    void route(const std::string& relativePath) {
+        ULJ_TRACE_SCOPE_DETAIL("HotReloadRouter::route", relativePath.c_str());
+        // Drop the stale contents from the process-wide cache once, before any view reloads
+        AudioPluginAudioProcessor::getSharedResourceCache().invalidate(juce::String(relativePath));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& subscription : subscribers) {
+            const auto& s = subscription.second;
+            if (!s.dependenciesKnown || s.dependencies.count(relativePath) > 0)
+                s.subscriber(relativePath);
+        }
+    }
+
+    std::mutex mutex;
+    std::map<int, Subscription> subscribers;
+    int nextId = 0;
+    std::unique_ptr<FileWatcher> fileWatcher;
+};
+
+#endif //ULTRALIGHTJUCE_HOTRELOADROUTER_H
@@ -0,0 +1,183 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_IDLEGARBAGECOLLECTOR_H
+#define ULTRALIGHTJUCE_IDLEGARBAGECOLLECTOR_H
+
+#include <juce_core/juce_core.h>
+#include <JavaScriptCore/JavaScript.h>
+
+#include "JSCPrivateAPI.h"
+#include "LockFreeHistogram.h"
+
+/// \brief Moves JavaScript garbage collection of a page into idle periods, so collections don't land in the middle of
+/// an interaction (e.g. a knob drag).
+///
+/// JavaScriptCore collects whenever its heuristics say so. By collecting while nothing happens, the heap is already
+/// clean when the user starts interacting, and the collector has less reason to run during the interaction.
+/// The page is idle once there was no interaction for `idleMs`: no input, no MarkInputHandled() from the page and no
+/// repaint in response to either. Other repaints (e.g. the live readouts, which update every few frames, or idle
+/// animations) don't count, otherwise a page that always shows something changing would never be idle. Then (at most
+/// once per `minIntervalMs`, and only if something happened since the last collection) shouldCollect() is true.
+///
+/// The frame time of interactive frames (frames within INTERACTION_WINDOW_MS of an input) is recorded, so the effect
+/// of the aggressiveness shows up as the p99 in getStats().
+///
+/// Message thread only.
+class IdleGarbageCollector {
+public:
+    enum class Aggressiveness {
+        Off = 0,    // Leave collection to JavaScriptCore
+        Hint,       // JSGarbageCollect(): tells JavaScriptCore that now is a good time, it decides what to collect
+        // The synchronous ones go through JavaScriptCore's debugging entry points (JSSynchronousEdenCollectForDebugging
+        // and JSSynchronousGarbageCollectForDebugging), so they are opt-in for experiments, not the default
+        Eden,       // Synchronous collection of the young generation (cheap, catches most per-interaction garbage)
+        Full        // Synchronous full collection (longest pause, smallest heap afterwards)
+    };
+
+    struct Settings {
+        Aggressiveness aggressiveness = Aggressiveness::Hint;
+        double idleMs = 500.0;          // Time without interaction before collecting
+        double minIntervalMs = 2000.0;  // Minimum time between two collections
+    };
+
+    /// \brief Frame time statistics in ms
+    struct Stats {
+        double interactionP50Ms = 0.0;  // Frames within INTERACTION_WINDOW_MS of an input
+        double interactionP99Ms = 0.0;
+        double interactionMaxMs = 0.0;
+        uint64_t interactionFrames = 0;
+        uint64_t collections = 0;
+        double collectionP50Ms = 0.0;   // Duration of the idle collections
+        double collectionMaxMs = 0.0;
+        int aggressiveness = 0;         // See Aggressiveness
+    };
+
+    /// \brief Frames this long after an input count as interactive
+    static constexpr double INTERACTION_WINDOW_MS = 250.0;
+
+    /// \brief Default settings for an aggressiveness (see IDLE_GC_AGGRESSIVENESS in Config.h)
+    static Settings getDefaultSettings(Aggressiveness aggressiveness) {
+        Settings settings;
+        settings.aggressiveness = aggressiveness;
+        switch (aggressiveness) {
+            case Aggressiveness::Off:
+                break;
+            case Aggressiveness::Hint:
+                settings.idleMs = 1000.0;
+                settings.minIntervalMs = 5000.0;
+                break;
+            case Aggressiveness::Eden:
+                settings.idleMs = 500.0;
+                settings.minIntervalMs = 2000.0;
+                break;
+            case Aggressiveness::Full:
+                settings.idleMs = 500.0;
+                settings.minIntervalMs = 5000.0;
+                break;
+        }
+        return settings;
+    }
+
+    IdleGarbageCollector() = default;
+    explicit IdleGarbageCollector(Settings settingsIn) : settings(settingsIn) {}
+
+    void setSettings(Settings newSettings) { settings = newSettings; }
+    const Settings& getSettings() const { return settings; }
+
+    /// \brief Call for every input event as it arrives
+    void inputReceived() noexcept {
+        lastInput = now();
+        lastResponse = lastInput;
+        lastInteraction = lastInput;
+        activitySinceCollection = true;
+    }
+
+    /// \brief Call when the page marks an input as handled (MarkInputHandled(), see InputLatencyMeter.h)
+    void inputHandled() noexcept {
+        lastResponse = now();
+        lastInteraction = lastResponse;
+        activitySinceCollection = true;
+    }
+
+    /// \brief Call after each frame
+    /// \param durationMs Time spent on the frame (input, update, render, pixel copy)
+    /// \param surfaceChanged True if the frame showed new pixels from the View
+    void frameFinished(double durationMs, bool surfaceChanged) noexcept {
+        const double time = now();
+        if (time - lastInput <= INTERACTION_WINDOW_MS)
+            interactionFrameTime.add(durationMs);
+        if (surfaceChanged) {
+            // Any repaint may have left garbage behind, but only the ones answering an input keep the page busy.
+            // Measured from the input itself, so an animation it started doesn't extend the interaction forever.
+            activitySinceCollection = true;
+            if (time - lastResponse <= INTERACTION_WINDOW_MS)
+                lastInteraction = time;
+        }
+    }
+
+    /// \brief True if the page has been idle long enough for a collection
+    /// \param pageHidden A hidden page counts as idle right away (no frames are rendered while hidden)
+    bool shouldCollect(bool pageHidden = false) const noexcept {
+        return settings.aggressiveness != Aggressiveness::Off
+               && activitySinceCollection
+               && (pageHidden || now() - lastInteraction >= settings.idleMs)
+               && now() - lastCollection >= settings.minIntervalMs;
+    }
+
+    /// \brief Collects the garbage of the context (lock it first, e.g. with View::LockJSContext())
+    /// Eden and Full fall back to JSGarbageCollect() if the Ultralight build doesn't export them.
+    void collect(JSContextRef ctx) {
+        if (ctx == nullptr || settings.aggressiveness == Aggressiveness::Off)
+            return;
+        const double start = now();
+        JSCPrivateAPI::SynchronousCollectFunction synchronousCollect = nullptr;
+        if (settings.aggressiveness == Aggressiveness::Eden)
+            synchronousCollect = JSCPrivateAPI::synchronousEdenCollect();
+        else if (settings.aggressiveness == Aggressiveness::Full)
+            synchronousCollect = JSCPrivateAPI::synchronousGarbageCollect();
+        if (synchronousCollect != nullptr)
+            synchronousCollect(ctx);
+        else
+            JSGarbageCollect(ctx);
+
+        lastCollection = now();
+        collectionTime.add(lastCollection - start);
+        activitySinceCollection = false;
+    }
+
+    Stats getStats() const noexcept {
+        Stats stats;
+        stats.interactionP50Ms = interactionFrameTime.getPercentile(50.0);
+        stats.interactionP99Ms = interactionFrameTime.getPercentile(99.0);
+        stats.interactionMaxMs = interactionFrameTime.getMax();
+        stats.interactionFrames = interactionFrameTime.getCount();
+        stats.collections = collectionTime.getCount();
+        stats.collectionP50Ms = collectionTime.getPercentile(50.0);
+        stats.collectionMaxMs = collectionTime.getMax();
+        stats.aggressiveness = static_cast<int>(settings.aggressiveness);
+        return stats;
+    }
+
+    void reset() noexcept {
+        interactionFrameTime.reset();
+        collectionTime.reset();
+    }
+
+private:
+    static double now() noexcept { return juce::Time::getMillisecondCounterHiRes(); }
+
+    Settings settings;
+    double lastInput = -INTERACTION_WINDOW_MS;
+    double lastResponse = -INTERACTION_WINDOW_MS;   // Last input or MarkInputHandled()
+    double lastInteraction = 0.0;                   // Last input, MarkInputHandled() or repaint answering them
+    double lastCollection = 0.0;
+    bool activitySinceCollection = true;
+    // Frame times in ms, 0.25 ms resolution up to 100 ms
+    LockFreeHistogram<400> interactionFrameTime { 100.0 };
+    // Collection times in ms, 0.5 ms resolution up to 250 ms
+    LockFreeHistogram<500> collectionTime { 250.0 };
+};
+
+#endif //ULTRALIGHTJUCE_IDLEGARBAGECOLLECTOR_H
@@ -0,0 +1,100 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_INPUTEVENTQUEUE_H
+#define ULTRALIGHTJUCE_INPUTEVENTQUEUE_H
+
+#include <Ultralight/Ultralight.h>
+#include <utility>
+#include <vector>
+
+/// \brief Collects the input events of one View between two frames and hands them to the View in one go, right
+/// before Renderer::Update().
+///
+/// High polling rate mice deliver hundreds of moves per second, but only the last position before a frame matters:
+/// consecutive moves (with the same button state) collapse into one, consecutive scrolls are summed up. Button
+/// presses and releases and key events are always kept, in order, so clicks, drags and typing behave exactly as before.
+///
+/// Message thread only. Doesn't allocate after the first few frames.
+class InputEventQueue {
+public:
+    InputEventQueue() {
+        events.reserve(32);
+    }
+
+    /// \return true if this is the first event since the last flush, i.e. the caller should request a repaint
+    bool push(const ultralight::MouseEvent& event) {
+        const bool wasEmpty = events.empty();
+        if (event.type == ultralight::MouseEvent::kType_MouseMoved && !events.empty()) {
+            auto& last = events.back();
+            if (last.kind == Kind::Mouse && last.mouse.type == ultralight::MouseEvent::kType_MouseMoved
+                && last.mouse.button == event.button) {
+                last.mouse = event;
+                return false;
+            }
+        }
+        Event queued;
+        queued.kind = Kind::Mouse;
+        queued.mouse = event;
+        events.push_back(queued);
+        return wasEmpty;
+    }
+
+    /// \return true if this is the first event since the last flush, i.e. the caller should request a repaint
+    bool push(const ultralight::ScrollEvent& event) {
+        const bool wasEmpty = events.empty();
+        if (!events.empty()) {
+            auto& last = events.back();
+            if (last.kind == Kind::Scroll && last.scroll.type == event.type) {
+                last.scroll.delta_x += event.delta_x;
+                last.scroll.delta_y += event.delta_y;
+                return false;
+            }
+        }
+        Event queued;
+        queued.kind = Kind::Scroll;
+        queued.scroll = event;
+        events.push_back(queued);
+        return wasEmpty;
+    }
+
+    /// \return true if this is the first event since the last flush, i.e. the caller should request a repaint
+    bool push(const ultralight::KeyEvent& event) {
+        const bool wasEmpty = events.empty();
+        Event queued;
+        queued.kind = Kind::Key;
+        queued.key = event;
+        events.push_back(std::move(queued));
+        return wasEmpty;
+    }
+
+    /// \brief Fires all queued events into the View (in order) and clears the queue
+    void flush(ultralight::View& view) {
+        for (const auto& event : events) {
+            if (event.kind == Kind::Mouse)
+                view.FireMouseEvent(event.mouse);
+            else if (event.kind == Kind::Scroll)
+                view.FireScrollEvent(event.scroll);
+            else
+                view.FireKeyEvent(event.key);
+        }
+        events.clear();
+    }
+
+    bool isEmpty() const { return events.empty(); }
+
+private:
+    enum class Kind { Mouse, Scroll, Key };
+
+    struct Event {
+        Kind kind = Kind::Mouse;
+        ultralight::MouseEvent mouse {};
+        ultralight::ScrollEvent scroll {};
+        ultralight::KeyEvent key;
+    };
+
+    std::vector<Event> events;
+};
+
+#endif //ULTRALIGHTJUCE_INPUTEVENTQUEUE_H
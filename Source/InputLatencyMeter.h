@@ -0,0 +1,124 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_INPUTLATENCYMETER_H
+#define ULTRALIGHTJUCE_INPUTLATENCYMETER_H
+
+#include <juce_core/juce_core.h>
+
+#include "LockFreeHistogram.h"
+
+/// \brief Measures the input-to-photon latency of a View: the time from an input event arriving in the editor until
+/// the first frame whose surface it changed is drawn.
+///
+/// Only input the page marks as handled counts: its handlers call MarkInputHandled() (in JS) when they changed what is
+/// shown. The page also repaints on its own (readouts, animations), so a dirty surface alone doesn't say which input,
+/// if any, caused it. A marked input is timed from its arrival to the next frame with a dirty surface; coalesced
+/// events (see InputEventQueue.h) count from the first one. Input that wasn't marked by the time the next input is
+/// fired into the View (e.g. moving the mouse over an empty area), or whose frame doesn't come within DROP_AFTER_MS,
+/// is dropped instead of being attributed to some later repaint. The time until MarkInputHandled() is recorded as well,
+/// which splits the latency into the part spent until JS handled the event and the part spent on layout, painting and
+/// copying the pixels.
+///
+/// "Photon" is the end of our paint(); the time the OS compositor and the display add on top isn't included.
+/// Written and read on the Message thread.
+class InputLatencyMeter {
+public:
+    /// \brief Latencies in ms
+    struct Stats {
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double meanMs = 0.0;
+        uint64_t frames = 0;        // Frames that showed the result of an input
+        uint64_t dropped = 0;       // Inputs that weren't marked as handled or didn't change the surface
+        double handledP50Ms = 0.0;  // Input until the page's handler called MarkInputHandled()
+        double handledP99Ms = 0.0;
+        uint64_t handled = 0;
+    };
+
+    /// \brief Handled inputs that haven't changed the surface after this long are dropped
+    static constexpr double DROP_AFTER_MS = 500.0;
+
+    /// \brief Call for every input event as it arrives
+    void inputReceived() noexcept {
+        if (pendingSince < 0.0)
+            pendingSince = now();
+    }
+
+    /// \brief Call right before the queued input is fired into the View
+    void inputsFlushed() noexcept {
+        if (pendingSince < 0.0)
+            return;
+        // Handlers run while the View is updated, so an earlier input that still isn't marked never will be
+        if (inFlightSince >= 0.0 && !handledMarked) {
+            ++dropped;
+            inFlightSince = -1.0;
+        }
+        // An earlier handled input that is still waiting for its frame stays the reference
+        if (inFlightSince < 0.0) {
+            inFlightSince = pendingSince;
+            handledMarked = false;
+        }
+        pendingSince = -1.0;
+    }
+
+    /// \brief Call when the page reports it handled the input (first call per input counts)
+    void markHandled() noexcept {
+        if (inFlightSince < 0.0 || handledMarked)
+            return;
+        handledMarked = true;
+        handledLatency.add(now() - inFlightSince);
+    }
+
+    /// \brief Call after a frame has been drawn
+    /// \param surfaceChanged True if the frame showed new pixels from the View
+    void framePresented(bool surfaceChanged) noexcept {
+        if (inFlightSince < 0.0)
+            return;
+        const double latency = now() - inFlightSince;
+        if (surfaceChanged && handledMarked)
+            photonLatency.add(latency);
+        else if (latency > DROP_AFTER_MS)
+            ++dropped;
+        else
+            return;
+        inFlightSince = -1.0;
+    }
+
+    Stats getStats() const noexcept {
+        Stats stats;
+        stats.p50Ms = photonLatency.getPercentile(50.0);
+        stats.p95Ms = photonLatency.getPercentile(95.0);
+        stats.p99Ms = photonLatency.getPercentile(99.0);
+        stats.maxMs = photonLatency.getMax();
+        stats.meanMs = photonLatency.getMean();
+        stats.frames = photonLatency.getCount();
+        stats.dropped = dropped;
+        stats.handledP50Ms = handledLatency.getPercentile(50.0);
+        stats.handledP99Ms = handledLatency.getPercentile(99.0);
+        stats.handled = handledLatency.getCount();
+        return stats;
+    }
+
+    void reset() noexcept {
+        photonLatency.reset();
+        handledLatency.reset();
+        dropped = 0;
+    }
+
+private:
+    static double now() noexcept { return juce::Time::getMillisecondCounterHiRes(); }
+
+    double pendingSince = -1.0;     // Oldest input that hasn't been fired into the View yet
+    double inFlightSince = -1.0;    // Oldest input fired into the View that hasn't changed the surface yet
+    bool handledMarked = false;
+    uint64_t dropped = 0;
+    // Latencies in ms, 0.5 ms resolution up to 250 ms
+    LockFreeHistogram<500> photonLatency { 250.0 };
+    LockFreeHistogram<500> handledLatency { 250.0 };
+};
+
+#endif //ULTRALIGHTJUCE_INPUTLATENCYMETER_H
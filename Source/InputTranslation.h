@@ -0,0 +1,275 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_INPUTTRANSLATION_H
+#define ULTRALIGHTJUCE_INPUTTRANSLATION_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/KeyCodes.h>
+#include <Ultralight/KeyEvent.h>
+#include <array>
+#include <cstdint>
+
+#include "InputEventQueue.h"
+
+namespace InputTranslationTables {
+
+struct AsciiKeyCodes {
+    uint8_t codes[128];
+};
+
+/// \brief Virtual key codes of the keys that produce printable ASCII characters (US layout)
+constexpr AsciiKeyCodes makeAsciiKeyCodes() {
+    AsciiKeyCodes table {};
+    using namespace ultralight::KeyCodes;
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table.codes[c] = static_cast<uint8_t>(GK_A + (c - 'a'));
+        table.codes[c - 'a' + 'A'] = static_cast<uint8_t>(GK_A + (c - 'a'));
+    }
+    for (int c = '0'; c <= '9'; ++c)
+        table.codes[c] = static_cast<uint8_t>(GK_0 + (c - '0'));
+    const char shiftedDigits[] = ")!@#$%^&*(";
+    for (int i = 0; i < 10; ++i)
+        table.codes[static_cast<int>(shiftedDigits[i])] = static_cast<uint8_t>(GK_0 + i);
+    table.codes[' '] = GK_SPACE;
+    table.codes[';'] = table.codes[':'] = GK_OEM_1;
+    table.codes['='] = table.codes['+'] = GK_OEM_PLUS;
+    table.codes[','] = table.codes['<'] = GK_OEM_COMMA;
+    table.codes['-'] = table.codes['_'] = GK_OEM_MINUS;
+    table.codes['.'] = table.codes['>'] = GK_OEM_PERIOD;
+    table.codes['/'] = table.codes['?'] = GK_OEM_2;
+    table.codes['`'] = table.codes['~'] = GK_OEM_3;
+    table.codes['['] = table.codes['{'] = GK_OEM_4;
+    table.codes['\\'] = table.codes['|'] = GK_OEM_5;
+    table.codes[']'] = table.codes['}'] = GK_OEM_6;
+    table.codes['\''] = table.codes['"'] = GK_OEM_7;
+    return table;
+}
+
+constexpr AsciiKeyCodes ASCII_KEY_CODES = makeAsciiKeyCodes();
+
+} // namespace InputTranslationTables
+
+/// \brief Translates JUCE mouse, wheel and key input into Ultralight events. Used by the main view and the inspector.
+///
+/// Key codes are looked up in tables: printable ASCII in a table built at compile time, JUCE's platform dependent
+/// codes of special keys (arrows, F-keys, ...) in a small table built on first use. Nothing is allocated per event,
+/// apart from the strings Ultralight's KeyEvent itself holds.
+///
+/// JUCE only reports key releases as "some key changed", so the keys that are down are tracked (keyPressed()) and
+/// checked for release in keyStateChanged(). That state is per component, hence one instance per component.
+/// Message thread only.
+class InputTranslation {
+public:
+    /// \brief Pixels scrolled per unit of JUCE wheel delta (a notch of a mouse wheel is about 0.1 - 0.125)
+    static constexpr float WHEEL_PIXELS_PER_UNIT = 1000.0f;
+
+    static ultralight::MouseEvent toMouseEvent(ultralight::MouseEvent::Type type, const juce::MouseEvent& event) {
+        ultralight::MouseEvent evt{};
+        evt.type = type;
+        evt.x = event.x;
+        evt.y = event.y;
+        if (type == ultralight::MouseEvent::kType_MouseMoved && !event.mods.isAnyMouseButtonDown())
+            evt.button = ultralight::MouseEvent::kButton_None;
+        else if (event.mods.isLeftButtonDown())
+            evt.button = ultralight::MouseEvent::kButton_Left;
+        else if (event.mods.isMiddleButtonDown())
+            evt.button = ultralight::MouseEvent::kButton_Middle;
+        else
+            evt.button = ultralight::MouseEvent::kButton_Right;
+        return evt;
+    }
+
+    static ultralight::ScrollEvent toScrollEvent(const juce::MouseWheelDetails& wheel) {
+        ultralight::ScrollEvent evt{};
+        evt.type = ultralight::ScrollEvent::kType_ScrollByPixel;
+        evt.delta_x = static_cast<int>(wheel.deltaX * WHEEL_PIXELS_PER_UNIT);
+        evt.delta_y = static_cast<int>(wheel.deltaY * WHEEL_PIXELS_PER_UNIT);
+        return evt;
+    }
+
+    static unsigned toModifiers(const juce::ModifierKeys& mods) {
+        unsigned modifiers = 0;
+        if (mods.isAltDown())
+            modifiers |= ultralight::KeyEvent::kMod_AltKey;
+        if (mods.isCtrlDown())
+            modifiers |= ultralight::KeyEvent::kMod_CtrlKey;
+        if (mods.isShiftDown())
+            modifiers |= ultralight::KeyEvent::kMod_ShiftKey;
+#if JUCE_MAC
+        // On macOS, JUCE's command modifier is the Cmd key (elsewhere it's the same as Ctrl)
+        if (mods.isCommandDown())
+            modifiers |= ultralight::KeyEvent::kMod_MetaKey;
+#endif
+        return modifiers;
+    }
+
+    /// \brief Ultralight's virtual key code (ultralight::KeyCodes) of a JUCE key code, GK_UNKNOWN if there is none
+    static int toVirtualKeyCode(int juceKeyCode, bool& isKeypad) {
+        for (const auto& key : getSpecialKeys()) {
+            if (key.juceKeyCode == juceKeyCode) {
+                isKeypad = key.isKeypad;
+                return key.virtualKeyCode;
+            }
+        }
+        isKeypad = false;
+        if (juceKeyCode > 0 && juceKeyCode < 128)
+            return InputTranslationTables::ASCII_KEY_CODES.codes[juceKeyCode];
+        return ultralight::KeyCodes::GK_UNKNOWN;
+    }
+
+    /// \brief Queues the events of a key press: a RawKeyDown, followed by a Char if the key produces text
+    /// \return true if the queue was empty before, i.e. the caller should request a repaint
+    bool keyPressed(const juce::KeyPress& key, InputEventQueue& queue) {
+        bool isKeypad = false;
+        const int juceKeyCode = key.getKeyCode();
+        const int virtualKeyCode = toVirtualKeyCode(juceKeyCode, isKeypad);
+        const auto modifiers = toModifiers(key.getModifiers());
+
+        // JUCE repeats keyPressed() while a key is held down
+        bool isAutoRepeat = false;
+        for (size_t i = 0; i < numHeldKeys && !isAutoRepeat; ++i)
+            isAutoRepeat = heldKeys[i].juceKeyCode == juceKeyCode;
+        if (!isAutoRepeat && numHeldKeys < heldKeys.size())
+            heldKeys[numHeldKeys++] = { juceKeyCode, virtualKeyCode, isKeypad };
+
+        ultralight::KeyEvent down;
+        down.type = ultralight::KeyEvent::kType_RawKeyDown;
+        down.virtual_key_code = virtualKeyCode;
+        down.native_key_code = 0;
+        down.modifiers = modifiers;
+        down.is_keypad = isKeypad;
+        down.is_auto_repeat = isAutoRepeat;
+        ultralight::GetKeyIdentifierFromVirtualKeyCode(virtualKeyCode, down.key_identifier);
+        bool wasEmpty = queue.push(down);
+
+        // Text input, unless the key is a shortcut (Ctrl+Alt is AltGr on Windows and does produce text)
+        const auto character = key.getTextCharacter();
+        const auto mods = key.getModifiers();
+        const bool isShortcut = mods.isCommandDown() && !mods.isAltDown();
+        if (character >= 0x20 && character != 0x7f && !isShortcut) {
+            ultralight::KeyEvent text;
+            text.type = ultralight::KeyEvent::kType_Char;
+            text.virtual_key_code = virtualKeyCode;
+            text.native_key_code = 0;
+            text.modifiers = modifiers;
+            text.is_keypad = isKeypad;
+            text.is_auto_repeat = isAutoRepeat;
+            text.text = toString(character);
+            text.unmodified_text = text.text;
+            wasEmpty = queue.push(text) || wasEmpty;
+        }
+        return wasEmpty;
+    }
+
+    /// \brief Queues a KeyUp for every key that was released since the last call
+    /// \return true if the queue was empty before, i.e. the caller should request a repaint
+    bool keyStateChanged(bool isKeyDown, InputEventQueue& queue) {
+        juce::ignoreUnused(isKeyDown);
+        bool wasEmpty = false;
+        for (size_t i = 0; i < numHeldKeys;) {
+            if (juce::KeyPress::isKeyCurrentlyDown(heldKeys[i].juceKeyCode)) {
+                ++i;
+                continue;
+            }
+            ultralight::KeyEvent up;
+            up.type = ultralight::KeyEvent::kType_KeyUp;
+            up.virtual_key_code = heldKeys[i].virtualKeyCode;
+            up.native_key_code = 0;
+            up.modifiers = toModifiers(juce::ModifierKeys::getCurrentModifiers());
+            up.is_keypad = heldKeys[i].isKeypad;
+            ultralight::GetKeyIdentifierFromVirtualKeyCode(up.virtual_key_code, up.key_identifier);
+            wasEmpty = queue.push(up) || wasEmpty;
+            heldKeys[i] = heldKeys[--numHeldKeys];
+        }
+        return wasEmpty;
+    }
+
+private:
+    struct SpecialKey {
+        int juceKeyCode;
+        int virtualKeyCode;
+        bool isKeypad;
+    };
+
+    /// \brief JUCE's key codes of special keys aren't compile-time constants (they differ per platform), so this
+    /// table is built on first use
+    static const std::array<SpecialKey, 43>& getSpecialKeys() {
+        using juce::KeyPress;
+        using namespace ultralight::KeyCodes;
+        static const std::array<SpecialKey, 43> keys {{
+            { KeyPress::backspaceKey, GK_BACK, false },
+            { KeyPress::tabKey, GK_TAB, false },
+            { KeyPress::returnKey, GK_RETURN, false },
+            { KeyPress::escapeKey, GK_ESCAPE, false },
+            { KeyPress::spaceKey, GK_SPACE, false },
+            { KeyPress::deleteKey, GK_DELETE, false },
+            { KeyPress::insertKey, GK_INSERT, false },
+            { KeyPress::homeKey, GK_HOME, false },
+            { KeyPress::endKey, GK_END, false },
+            { KeyPress::pageUpKey, GK_PRIOR, false },
+            { KeyPress::pageDownKey, GK_NEXT, false },
+            { KeyPress::leftKey, GK_LEFT, false },
+            { KeyPress::rightKey, GK_RIGHT, false },
+            { KeyPress::upKey, GK_UP, false },
+            { KeyPress::downKey, GK_DOWN, false },
+            { KeyPress::F1Key, GK_F1, false },
+            { KeyPress::F2Key, GK_F2, false },
+            { KeyPress::F3Key, GK_F3, false },
+            { KeyPress::F4Key, GK_F4, false },
+            { KeyPress::F5Key, GK_F5, false },
+            { KeyPress::F6Key, GK_F6, false },
+            { KeyPress::F7Key, GK_F7, false },
+            { KeyPress::F8Key, GK_F8, false },
+            { KeyPress::F9Key, GK_F9, false },
+            { KeyPress::F10Key, GK_F10, false },
+            { KeyPress::F11Key, GK_F11, false },
+            { KeyPress::F12Key, GK_F12, false },
+            { KeyPress::numberPad0, GK_NUMPAD0, true },
+            { KeyPress::numberPad1, GK_NUMPAD1, true },
+            { KeyPress::numberPad2, GK_NUMPAD2, true },
+            { KeyPress::numberPad3, GK_NUMPAD3, true },
+            { KeyPress::numberPad4, GK_NUMPAD4, true },
+            { KeyPress::numberPad5, GK_NUMPAD5, true },
+            { KeyPress::numberPad6, GK_NUMPAD6, true },
+            { KeyPress::numberPad7, GK_NUMPAD7, true },
+            { KeyPress::numberPad8, GK_NUMPAD8, true },
+            { KeyPress::numberPad9, GK_NUMPAD9, true },
+            { KeyPress::numberPadAdd, GK_ADD, true },
+            { KeyPress::numberPadSubtract, GK_SUBTRACT, true },
+            { KeyPress::numberPadMultiply, GK_MULTIPLY, true },
+            { KeyPress::numberPadDivide, GK_DIVIDE, true },
+            { KeyPress::numberPadDecimalPoint, GK_DECIMAL, true },
+            { KeyPress::numberPadEquals, GK_OEM_PLUS, true },
+        }};
+        return keys;
+    }
+
+    /// \brief UTF-16 string of one character, without going through UTF-8
+    static ultralight::String toString(juce::juce_wchar character) {
+        ultralight::Char16 units[2];
+        size_t length = 1;
+        if (character >= 0x10000) {
+            const auto c = static_cast<uint32_t>(character) - 0x10000;
+            units[0] = static_cast<ultralight::Char16>(0xd800 + (c >> 10));
+            units[1] = static_cast<ultralight::Char16>(0xdc00 + (c & 0x3ff));
+            length = 2;
+        } else {
+            units[0] = static_cast<ultralight::Char16>(character);
+        }
+        return ultralight::String(units, length);
+    }
+
+    struct HeldKey {
+        int juceKeyCode;
+        int virtualKeyCode;
+        bool isKeypad;
+    };
+
+    std::array<HeldKey, 16> heldKeys {};
+    size_t numHeldKeys = 0;
+};
+
+#endif //ULTRALIGHTJUCE_INPUTTRANSLATION_H
@@ -7,15 +7,15 @@
 #ifndef ULTRALIGHTJUCE_INSPECTORMODALWINDOW_H
 #define ULTRALIGHTJUCE_INSPECTORMODALWINDOW_H
 
-#include <codecvt>
 #include <string>
-#include <regex>
 #include <JuceHeader.h>
 #include <Ultralight/Ultralight.h>
 
 #include "Ultralight/KeyEvent.h"
 #include "Ultralight/String.h"
 #include "GUIMainComponent.h"
+#include "InputEventQueue.h"
+#include "InputTranslation.h"
 
 class ImageComponent : public juce::Component
 {
@@ -30,8 +30,9 @@ public:
     // Same as in GUIMainComponent.h, see there for more details
     void paint(juce::Graphics& g) override
     {
-        AudioPluginAudioProcessor::RENDERER->Update();
-        AudioPluginAudioProcessor::RENDERER->Render();
+        inputQueue.flush(*inspectorView);
+        AudioPluginAudioProcessor::getRenderer()->Update();
+        AudioPluginAudioProcessor::getRenderer()->Render();
 
         auto *surface = (ultralight::BitmapSurface *) (inspectorView->surface());
 
@@ -61,72 +62,58 @@ public:
 
     void mouseMove(const juce::MouseEvent& event) override
     {
-//        DBG("Inspector Mouse moved: " << event.x << ", " << event.y);
-        ultralight::MouseEvent evt{};
-        evt.type = ultralight::MouseEvent::kType_MouseMoved;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = ultralight::MouseEvent::kButton_None;
-        inspectorView->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(ultralight::MouseEvent::kType_MouseMoved, event));
     }
 
     void mouseDown(const juce::MouseEvent& event) override
     {
-//        DBG("Inspector Mouse down: " << event.x << ", " << event.y);
-        ultralight::MouseEvent evt{};
-        evt.type = ultralight::MouseEvent::kType_MouseDown;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? ultralight::MouseEvent::kButton_Left : ultralight::MouseEvent::kButton_Right;
-        inspectorView->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(ultralight::MouseEvent::kType_MouseDown, event));
     }
 
     void mouseDrag(const juce::MouseEvent& event) override
     {
-//        DBG("Inspector Mouse drag: " << event.x << ", " << event.y);
-        ultralight::MouseEvent evt{};
-        evt.type = ultralight::MouseEvent::kType_MouseMoved;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? ultralight::MouseEvent::kButton_Left : ultralight::MouseEvent::kButton_Right;
-        inspectorView->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(ultralight::MouseEvent::kType_MouseMoved, event));
     }
 
     void mouseUp(const juce::MouseEvent& event) override
     {
-//        DBG("Inspector Mouse up: " << event.x << ", " << event.y);
-        ultralight::MouseEvent evt{};
-        evt.type = ultralight::MouseEvent::kType_MouseUp;
-        evt.x = event.x;
-        evt.y = event.y;
-        evt.button = event.mods.isLeftButtonDown() ? ultralight::MouseEvent::kButton_Left : ultralight::MouseEvent::kButton_Right;
-        inspectorView->FireMouseEvent(evt);
-        repaint();
+        queueInput(InputTranslation::toMouseEvent(ultralight::MouseEvent::kType_MouseUp, event));
     }
 
     void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override
     {
-        // Handle the scroll event here
-        const float scrollDeltaX = wheel.deltaX;
-        const float scrollDeltaY = wheel.deltaY;
+        juce::ignoreUnused(event);
+        queueInput(InputTranslation::toScrollEvent(wheel));
+    }
 
-        // Perform actions based on the scroll direction and amount
-        ultralight::ScrollEvent evt{};
-        evt.type = ultralight::ScrollEvent::kType_ScrollByPixel;
-        // Scroll Y
-        evt.delta_x = static_cast<int>(scrollDeltaX * 100.0);
-        evt.delta_y = static_cast<int>(scrollDeltaY * 1000.0);
-//        DBG("Inspector Mouse wheel x: " << evt.delta_x << ", y:" << evt.delta_y);
-        inspectorView->FireScrollEvent(evt);
+    // Key events of the inspector window (see InspectorModalWindow::keyPressed)
+    void forwardKeyPressed(const juce::KeyPress& key)
+    {
+        if (keyTranslation.keyPressed(key, inputQueue))
+            repaint();
+    }
+
+    void forwardKeyStateChanged(bool isKeyDown)
+    {
+        if (keyTranslation.keyStateChanged(isKeyDown, inputQueue))
+            repaint();
     }
 
 private:
     juce::Image& image;
     ultralight::RefPtr<ultralight::View>& inspectorView;
     double& JUCE_SCALE;
+    // Input events since the last frame (see InputEventQueue.h)
+    InputEventQueue inputQueue;
+    // Keys currently held down (for key up events)
+    InputTranslation keyTranslation;
+
+    template<typename Event>
+    void queueInput(const Event& event)
+    {
+        if (inputQueue.push(event))
+            repaint();
+    }
 };
 
 class InspectorModalWindow :
@@ -191,80 +178,25 @@ public:
 
     bool keyPressed(const juce::KeyPress& key, juce::Component* originatingComponent) override
     {
-        // Check if key character contains only single letter or number
-        std::regex regexPattern(R"([A-Za-z0-9`\-=[\\\];',./~!@#$%^&*()_+{}|:"<>?\u0020])");
-        // Convert from wchar_t to string
-        auto wstr = std::wstring(1, key.getTextCharacter()).c_str();
-        std::string str = converter.to_bytes(wstr);
-
-        ultralight::KeyEvent evt;
-        if(std::regex_match(str, regexPattern)){
-            // Single character
-            evt.type = ultralight::KeyEvent::kType_Char;
-            ultralight::String keyStr(str.c_str());
-            evt.text = keyStr;
-            evt.native_key_code = 0;
-            evt.modifiers = 0;
-            evt.unmodified_text = evt.text; // If not available, set to same as evt.text
-        } else {
-            // Special keys
-            evt.type = ultralight::KeyEvent::kType_RawKeyDown;
-            evt.virtual_key_code = mapJUCEKeyCodeToUltralight(key.getKeyCode());
-            evt.native_key_code = 0;
-            evt.modifiers = 0;
-            GetKeyIdentifierFromVirtualKeyCode(evt.virtual_key_code, evt.key_identifier);
-        }
-
-        inspectorView->FireKeyEvent(evt);
-
+        imageComponent->forwardKeyPressed(key);
         return true; // Indicate that the key press is consumed
     }
 
-    void closeButtonPressed() override
+    bool keyStateChanged(bool isKeyDown, juce::Component* originatingComponent) override
     {
-        // Close the modal window
-        setVisible(false);
+        imageComponent->forwardKeyStateChanged(isKeyDown);
+        return true;
     }
 
-    int mapJUCEKeyCodeToUltralight(int juceKeyCode)
+    void closeButtonPressed() override
     {
-        if (juceKeyCode == juce::KeyPress::backspaceKey) return ultralight::KeyCodes::GK_BACK;
-        else if (juceKeyCode == juce::KeyPress::tabKey) return ultralight::KeyCodes::GK_TAB;
-        else if (juceKeyCode == juce::KeyPress::returnKey) return ultralight::KeyCodes::GK_RETURN;
-        else if (juceKeyCode == juce::KeyPress::escapeKey) return ultralight::KeyCodes::GK_ESCAPE;
-        else if (juceKeyCode == juce::KeyPress::spaceKey) return ultralight::KeyCodes::GK_SPACE;
-        else if (juceKeyCode == juce::KeyPress::deleteKey) return ultralight::KeyCodes::GK_DELETE;
-        else if (juceKeyCode == juce::KeyPress::homeKey) return ultralight::KeyCodes::GK_HOME;
-        else if (juceKeyCode == juce::KeyPress::endKey) return ultralight::KeyCodes::GK_END;
-        else if (juceKeyCode == juce::KeyPress::pageUpKey) return ultralight::KeyCodes::GK_PRIOR;
-        else if (juceKeyCode == juce::KeyPress::pageDownKey) return ultralight::KeyCodes::GK_NEXT;
-        else if (juceKeyCode == juce::KeyPress::leftKey) return ultralight::KeyCodes::GK_LEFT;
-        else if (juceKeyCode == juce::KeyPress::rightKey) return ultralight::KeyCodes::GK_RIGHT;
-        else if (juceKeyCode == juce::KeyPress::upKey) return ultralight::KeyCodes::GK_UP;
-        else if (juceKeyCode == juce::KeyPress::downKey) return ultralight::KeyCodes::GK_DOWN;
-        else if (juceKeyCode == juce::KeyPress::F1Key) return ultralight::KeyCodes::GK_F1;
-        else if (juceKeyCode == juce::KeyPress::F2Key) return ultralight::KeyCodes::GK_F2;
-        else if (juceKeyCode == juce::KeyPress::F3Key) return ultralight::KeyCodes::GK_F3;
-        else if (juceKeyCode == juce::KeyPress::F4Key) return ultralight::KeyCodes::GK_F4;
-        else if (juceKeyCode == juce::KeyPress::F5Key) return ultralight::KeyCodes::GK_F5;
-        else if (juceKeyCode == juce::KeyPress::F6Key) return ultralight::KeyCodes::GK_F6;
-        else if (juceKeyCode == juce::KeyPress::F7Key) return ultralight::KeyCodes::GK_F7;
-        else if (juceKeyCode == juce::KeyPress::F8Key) return ultralight::KeyCodes::GK_F8;
-        else if (juceKeyCode == juce::KeyPress::F9Key) return ultralight::KeyCodes::GK_F9;
-        else if (juceKeyCode == juce::KeyPress::F10Key) return ultralight::KeyCodes::GK_F10;
-        else if (juceKeyCode == juce::KeyPress::F11Key) return ultralight::KeyCodes::GK_F11;
-        else if (juceKeyCode == juce::KeyPress::F12Key) return ultralight::KeyCodes::GK_F12;
-            // Add more if-else conditions for other JUCE keycodes as needed
-        else return -1; // Return -1 if there's no matching Ultralight keycode
+        // Close the modal window
+        setVisible(false);
     }
 
 private:
     std::unique_ptr<ImageComponent> imageComponent;
     ultralight::RefPtr<ultralight::View>& inspectorView;
     double& JUCE_SCALE;
-
-    // For string conversions
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-
 };
 #endif //ULTRALIGHTJUCE_INSPECTORMODALWINDOW_H
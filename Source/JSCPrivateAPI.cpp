@@ -0,0 +1,48 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#include "JSCPrivateAPI.h"
+
+namespace {
+    void* findFunction (const char* name)
+    {
+        // The library is already loaded (we link against it), opening it again only gets a handle
+        static juce::DynamicLibrary library;
+#if JUCE_WINDOWS
+        static const char* libraryName = "WebCore.dll";
+#elif JUCE_MAC
+        static const char* libraryName = "libWebCore.dylib";
+#else
+        static const char* libraryName = "libWebCore.so";
+#endif
+        static const bool opened = library.open (libraryName);
+        if (! opened)
+        {
+            DBG ("JSCPrivateAPI: can't open " << libraryName << ", " << name << " is unavailable");
+            return nullptr;
+        }
+        auto* function = library.getFunction (name);
+        if (function == nullptr)
+            DBG ("JSCPrivateAPI: " << name << " is not exported");
+        return function;
+    }
+}
+
+JSCPrivateAPI::GetMemoryUsageStatisticsFunction JSCPrivateAPI::getMemoryUsageStatistics()
+{
+    static const auto function = reinterpret_cast<GetMemoryUsageStatisticsFunction> (findFunction ("JSGetMemoryUsageStatistics"));
+    return function;
+}
+
+JSCPrivateAPI::SynchronousCollectFunction JSCPrivateAPI::synchronousGarbageCollect()
+{
+    static const auto function = reinterpret_cast<SynchronousCollectFunction> (findFunction ("JSSynchronousGarbageCollectForDebugging"));
+    return function;
+}
+
+JSCPrivateAPI::SynchronousCollectFunction JSCPrivateAPI::synchronousEdenCollect()
+{
+    static const auto function = reinterpret_cast<SynchronousCollectFunction> (findFunction ("JSSynchronousEdenCollectForDebugging"));
+    return function;
+}
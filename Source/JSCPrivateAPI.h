@@ -0,0 +1,25 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_JSCPRIVATEAPI_H
+#define ULTRALIGHTJUCE_JSCPRIVATEAPI_H
+
+#include <JuceHeader.h>
+#include <JavaScriptCore/JavaScript.h>
+
+/// \brief Runtime access to JavaScriptCore functions that are exported by Ultralight's WebCore library but not declared
+/// in its headers (JSBasePrivate.h in WebKit). Every function may be missing in a given Ultralight build, callers must
+/// handle nullptr. Implemented in JSCPrivateAPI.cpp.
+namespace JSCPrivateAPI {
+    // Returns an object with heapSize, heapCapacity, extraMemorySize and objectCount
+    using GetMemoryUsageStatisticsFunction = JSObjectRef (*) (JSContextRef);
+    // Collects synchronously (JSGarbageCollect() only tells the collector that now would be a good time)
+    using SynchronousCollectFunction = void (*) (JSContextRef);
+
+    GetMemoryUsageStatisticsFunction getMemoryUsageStatistics();
+    SynchronousCollectFunction synchronousGarbageCollect();
+    SynchronousCollectFunction synchronousEdenCollect();
+}
+
+#endif //ULTRALIGHTJUCE_JSCPRIVATEAPI_H
@@ -9,6 +9,7 @@
 #include <JavaScriptCore/JSRetainPtr.h>
 #include <JavaScriptCore/JavaScript.h>
 #include <JuceHeader.h>
+#include <atomic>
 #include <functional>
 #include <tuple>
 #include <type_traits>
@@ -17,6 +18,11 @@
 
 #include "Ultralight/View.h"
 #include "Ultralight/RefPtr.h"
+#include "JSStructFields.h"
+#include "PageVisibility.h"
+#include "ParameterMirror.h"
+#include "SpriteAtlas.h"
+#include "TraceEvents.h"
 
 /// \brief Base class for all JS interoperation. This class is used to invoke JS methods from C++ and vice versa.
 /// You can extend this class to add your own JS interoperation. An example of how to subclass it is given in
@@ -26,7 +32,7 @@ class JSInteropBase :
         {
 public:
     JSInteropBase(ultralight::View& inView, juce::AudioProcessorValueTreeState& params, juce::AudioProcessorValueTreeState::Listener& parentComponent)
-    : view(inView), audioParams(params), parent(parentComponent)
+    : view(inView), audioParams(params), parent(parentComponent), parameterMirror(params.processor)
     {
     }
 
@@ -41,7 +47,7 @@ public:
         JSContextRef ctx = context.get();
         // Register this class (JSInterop) as a global object in JavaScript
         JSObjectRef globalObj = JSContextGetGlobalObject(ctx);
-        JSStringRef name = JSStringCreateWithUTF8CString("JSInterop");
+        JSStringRef name = CreateJSString("JSInterop");
         // We need to create our custom JS class definition here in order to use JSObjectSetPrivate
         // Default JS classes don't allow us to set a private instance pointer
         JSClassDefinition classDef = kJSClassDefinitionEmpty;
@@ -57,6 +63,36 @@ public:
 
         // Register APVTS parameter update callback
         registerCppFunctionInJS("OnParameterUpdate", OnParameterUpdate);
+
+        // Lets the page mark when it handled an input event, see InputLatencyMeter.h
+        std::function<void()> markInputHandled = [this]() {
+            if (onInputHandled)
+                onInputHandled();
+        };
+        registerCppCallbackInJS("MarkInputHandled", markInputHandled);
+
+        // Parameter values and transport as a Float32Array, updated every frame (see ParameterMirror.h).
+        // Pages that read everything from it can turn off the XML pushes to APVTSUpdate() with DisableAPVTSPush().
+        parameterMirror.install(ctx);
+        apvtsPushEnabled = true;
+        std::function<void()> disableAPVTSPush = [this]() { apvtsPushEnabled = false; };
+        registerCppCallbackInJS("DisableAPVTSPush", disableAPVTSPush);
+
+        // Layout of the pre-rendered control sprites, and SpriteAtlas.setFrame() (see SpriteAtlas.h)
+        {
+            ultralight::String exception;
+            view.EvaluateScript(SpriteAtlas::getManifestScript().toRawUTF8(), &exception);
+            if (!exception.empty())
+                DBG("SpriteAtlas: " << exception.utf8().data());
+        }
+
+        // Hold back requestAnimationFrame() while the editor is hidden (see PageVisibility.h)
+        PageVisibility::install(view);
+        if (pageHidden)
+            PageVisibility::setHidden(view, true);
+
+        // A new page is being loaded, its DOM is not ready yet
+        domReady = false;
     }
 
     /// \brief This function is called by Ultralight once the DOM has been loaded. 
@@ -65,6 +101,8 @@ public:
 					uint64_t frame_id,
 					bool is_main_frame,
 					const ultralight::String& url) override {
+        domReady = true;
+
         // === JUCE APVTS PARAMS ===
         // Propagate all parameters that were loaded from disk to JS
         for (auto param : audioParams.processor.getParameters()) {
@@ -76,15 +114,48 @@ public:
         }
 	}
 
+    /// \brief True once the DOM of the current page is ready, i.e. JS functions of the page can be invoked
+    bool isDOMReady() const { return domReady; }
+
+    /// \brief Tells the page whether the editor is hidden (document.hidden, requestAnimationFrame() is paused)
+    void setPageHidden(bool hidden) {
+        if (hidden == pageHidden)
+            return;
+        pageHidden = hidden;
+        PageVisibility::setHidden(view, hidden);
+    }
+
+    bool isPageHidden() const { return pageHidden; }
+
+    /// \brief The page's mirror of all parameter values, snapshot() it once per frame (Message thread)
+    ParameterMirror& getParameterMirror() { return parameterMirror; }
+
+    /// \brief False if the page called DisableAPVTSPush(), i.e. it reads parameters from the ParameterMirror only and
+    /// pushAPVTSState() is not needed (any thread)
+    bool isAPVTSPushEnabled() const { return apvtsPushEnabled; }
+
+    /// \brief Called when the page calls MarkInputHandled() from an input event handler that changed what is shown
+    /// (Message thread)
+    std::function<void()> onInputHandled;
+
+    /// \brief Sends the whole APVTS as XML string to JS (to the APVTSUpdate() function in Resources/script.js).
+    /// Must be called on the JUCE Message thread.
+    void pushAPVTSState() {
+        ULJ_TRACE_SCOPE("pushAPVTSState");
+        juce::String xml = audioParams.copyState().createXml()->toString();
+        invokeMethod("APVTSUpdate", xml);
+    }
+
     /// \brief APVTS parameter propagation to JS. See how it is handled in Resources/script.js.
     static JSValueRef OnParameterUpdate(JSContextRef ctx, JSObjectRef function,
                                         JSObjectRef thisObject, size_t argumentCount,
                                         const JSValueRef arguments[], JSValueRef* exception) {
+        ULJ_TRACE_SCOPE("OnParameterUpdate");
         // Get the class instance pointer from the JS object
         auto* instance = GetInstance(ctx);
 
         // Get the parameter ID
-        auto parameterID = JSValueToStringCopy(ctx, arguments[0], nullptr);
+        auto parameterID = CopyJSString(ctx, arguments[0]);
         // Allocate a char* of length JSStringGetLength(parameterID)
         char* parameterIDStr = new char[JSStringGetLength(parameterID) + 1];
         JSStringGetUTF8CString(parameterID, parameterIDStr, JSStringGetLength(parameterID));
@@ -95,7 +166,7 @@ public:
         // Update the parameter value in JUCE
         instance->audioParams.getParameter(parameterIDStr)->setValueNotifyingHost(static_cast<float>(newValue));
 
-        JSStringRelease(parameterID);
+        ReleaseJSString(parameterID);
         delete[] parameterIDStr;
         return JSValueMakeNull(ctx);
     }
@@ -105,6 +176,7 @@ public:
     // ========================================================================================================
     template<typename... T>
     void invokeMethod(const juce::String& methodName, const T&... value) {
+        ULJ_TRACE_SCOPE_DETAIL("invokeMethod", methodName.toRawUTF8());
         // Get the JSContext from the View
         ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
         JSContextRef ctx = context.get();
@@ -143,20 +215,24 @@ public:
     // ========================================================================================================
     /// \brief Registers a C++ lambda or function object with the JS of the view. Functions registered with this method
     /// can be called from JS and will produce a callback in C++.
+    /// If the function returns a value, it is converted with CreateJSValue() and returned to JS synchronously, e.g.
+    /// `const text = GetParameterText("gain");` in JS. This saves the round trip of requesting a value from JS and
+    /// pushing it back with invokeMethod().
     /// \param functionName The name of the function as it will be called from JS
     /// \param callbackFunction The C++ function that will be called when the JS function is called. Accepts lambdas.
-    template<typename... T>
-    void registerCppCallbackInJS(const juce::String& functionName, std::function<void(T...)> callbackFunction) {
+    template<typename R, typename... T>
+    void registerCppCallbackInJS(const juce::String& functionName, std::function<R(T...)> callbackFunction) {
         // Get JS context
         ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
         JSContextRef ctx = context.get();
         // Create a JavaScript String containing the name of our callback.
-        JSStringRef name = JSStringCreateWithUTF8CString(functionName.toRawUTF8());
+        JSStringRef name = CreateJSString(functionName.toRawUTF8());
 
         // Create a JavaScript object with a private data member to hold the callback function and argument
         struct JSFunctionWrapper {
-            std::function<void(T...)> callback;
+            std::function<R(T...)> callback;
             std::tuple<T...> arguments;
+            juce::String name;  // For tracing
         };
 
         // Define a JavaScript callback function that will call the C++ lambda or function object
@@ -164,11 +240,17 @@ public:
                                                        size_t argumentCount, const JSValueRef arguments[],
                                                        JSValueRef* exception) -> JSValueRef {
             // Retrieve the stored callback function and argument from the private data of the JS object
-            JSObjectRef functionWrapper = JSValueToObject(ctx, JSObjectGetProperty(ctx, function, JSStringCreateWithUTF8CString("callback"), nullptr), nullptr);
+            JSObjectRef functionWrapper = JSValueToObject(ctx, JSObjectGetProperty(ctx, function, GetCallbackPropertyName(), nullptr), nullptr);
             JSFunctionWrapper* wrapper = reinterpret_cast<JSFunctionWrapper*>(JSObjectGetPrivate(functionWrapper));
             if (wrapper != nullptr) {
+                ULJ_TRACE_SCOPE_DETAIL("JS callback", wrapper->name.toRawUTF8());
                 // Convert the JavaScript arguments to the desired C++ types and call the callback function
-                std::apply(wrapper->callback, GetConvertedArguments<T...>(ctx, arguments, argumentCount, wrapper->arguments));
+                if constexpr (std::is_void<R>::value) {
+                    std::apply(wrapper->callback, GetConvertedArguments<T...>(ctx, arguments, argumentCount, wrapper->arguments));
+                } else {
+                    // Convert the return value and hand it straight back to JS
+                    return CreateJSValue(ctx, std::apply(wrapper->callback, GetConvertedArguments<T...>(ctx, arguments, argumentCount, wrapper->arguments)));
+                }
             }
             return JSValueMakeUndefined(ctx);
         };
@@ -178,19 +260,27 @@ public:
         functionWrapperClassDef.className = "JSFunctionWrapper";
         JSClassRef functionWrapperClass = JSClassCreate(&functionWrapperClassDef);
         JSObjectRef functionWrapper = JSObjectMake(ctx, functionWrapperClass, nullptr);
-        JSObjectSetPrivate(functionWrapper, new JSFunctionWrapper{ callbackFunction });
+        JSObjectSetPrivate(functionWrapper, new JSFunctionWrapper{ callbackFunction, {}, functionName });
+        getInteropCounters().functionWrappersCreated.fetch_add(1, std::memory_order_relaxed);
 
         // Create a garbage-collected JavaScript function that is bound to our native C callback 'jsCallback'.
         JSObjectRef func = JSObjectMakeFunctionWithCallback(ctx, name, jsCallback);
         // Set the callback function as a private member of the JavaScript function object
-        JSObjectSetProperty(ctx, func, JSStringCreateWithUTF8CString("callback"), functionWrapper, 0, nullptr);
+        JSObjectSetProperty(ctx, func, GetCallbackPropertyName(), functionWrapper, 0, nullptr);
 
         // Get the global JavaScript object (aka 'window')
         JSObjectRef globalObj = JSContextGetGlobalObject(ctx);
         // Store our function in the page's global JavaScript object so that it is accessible from the page as '{callbackFunction}()'.
         JSObjectSetProperty(ctx, globalObj, name, func, 0, nullptr);
         // Release the JavaScript String we created earlier.
-        JSStringRelease(name);
+        ReleaseJSString(name);
+    }
+
+    /// \brief Name of the property that holds the JSFunctionWrapper on registered callback functions.
+    /// Created once, since it is looked up on every call from JS.
+    static JSStringRef GetCallbackPropertyName() {
+        static JSStringRef callbackPropertyName = JSStringCreateWithUTF8CString("callback");
+        return callbackPropertyName;
     }
 
     /// \brief Registers a C++ function with the JS of the view. Functions registered with this method can be called
@@ -202,7 +292,7 @@ public:
         ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
         JSContextRef ctx = context.get();
         // Create a JavaScript String containing the name of our callback.
-        JSStringRef name = JSStringCreateWithUTF8CString(functionName.toRawUTF8());
+        JSStringRef name = CreateJSString(functionName.toRawUTF8());
         // Create a garbage-collected JavaScript function that is bound to our native C callback 'callbackFunction'.
         JSObjectRef func = JSObjectMakeFunctionWithCallback(ctx, name, callbackFunction);
         // Get the global JavaScript object (aka 'window')
@@ -210,44 +300,81 @@ public:
         // Store our function in the page's global JavaScript object so that it accessible from the page as '{callbackFunction}()'.
         JSObjectSetProperty(ctx, globalObj, name, func, 0, 0);
         // Release the JavaScript String we created earlier.
-        JSStringRelease(name);
+        ReleaseJSString(name);
+    }
+
+    // ================================== INTEROP COUNTERS ==================================
+    /// \brief Process-wide counts of the JS objects the interop layer creates, so leaks show up as growing
+    /// differences over time (see MemoryAccounting.h). Strings owned by a JSRetainPtr aren't counted.
+    struct InteropCounters {
+        std::atomic<uint64_t> jsStringsCreated { 0 };
+        std::atomic<uint64_t> jsStringsReleased { 0 };
+        // Never freed: one per registered callback and page load
+        std::atomic<uint64_t> functionWrappersCreated { 0 };
+    };
+
+    static InteropCounters& getInteropCounters() {
+        static InteropCounters counters;
+        return counters;
+    }
+
+    static JSStringRef CreateJSString(const char* string) {
+        getInteropCounters().jsStringsCreated.fetch_add(1, std::memory_order_relaxed);
+        return JSStringCreateWithUTF8CString(string);
+    }
+
+    static JSStringRef CopyJSString(JSContextRef ctx, JSValueRef value) {
+        getInteropCounters().jsStringsCreated.fetch_add(1, std::memory_order_relaxed);
+        return JSValueToStringCopy(ctx, value, nullptr);
+    }
+
+    static void ReleaseJSString(JSStringRef string) {
+        getInteropCounters().jsStringsReleased.fetch_add(1, std::memory_order_relaxed);
+        JSStringRelease(string);
     }
 
     // ================================== HELPER FUNCTIONS ==================================
     // C++ -> JS
     // Helper function to convert different types to JSValueRef
-    // TODO: Add code for handling more complex data yourself (e.g., using a string parser)
+    // Structs are supported by declaring their fields once with JSStructFields, see JSStructFields.h
     template<typename T>
-    JSValueRef CreateJSValue(JSContextRef ctx, const T& value) {
-        // Default implementation for unsupported types
-        DBG("JSInterop::CreateJSValue: Unsupported type.");
-        return JSValueMakeUndefined(ctx);
+    static JSValueRef CreateJSValue(JSContextRef ctx, const T& value) {
+        if constexpr (IsJSStruct<T>::value) {
+            return CreateJSStructValue(ctx, value);
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            // Any other number type (double, int64_t, ...)
+            return JSValueMakeNumber(ctx, static_cast<double>(value));
+        } else {
+            // Default implementation for unsupported types
+            DBG("JSInterop::CreateJSValue: Unsupported type.");
+            return JSValueMakeUndefined(ctx);
+        }
     }
 
     // float
     template<>
-    JSValueRef CreateJSValue(JSContextRef ctx, const float& value) {
+    static JSValueRef CreateJSValue(JSContextRef ctx, const float& value) {
         return JSValueMakeNumber(ctx, static_cast<double>(value));
     }
     // int
     template<>
-    JSValueRef CreateJSValue(JSContextRef ctx, const int& value) {
+    static JSValueRef CreateJSValue(JSContextRef ctx, const int& value) {
         return JSValueMakeNumber(ctx, static_cast<double>(value));
     }
     // bool
     template<>
-    JSValueRef CreateJSValue(JSContextRef ctx, const bool& value) {
+    static JSValueRef CreateJSValue(JSContextRef ctx, const bool& value) {
         return JSValueMakeBoolean(ctx, value);
     }
     // String
     template<>
-    JSValueRef CreateJSValue(JSContextRef ctx, const juce::String& value) {
-        return JSValueMakeString(ctx, JSStringCreateWithUTF8CString(value.toRawUTF8()));
+    static JSValueRef CreateJSValue(JSContextRef ctx, const juce::String& value) {
+        return JSValueMakeString(ctx, CreateJSString(value.toRawUTF8()));
     }
 
     // Lists/Arrays (using std::vectors)
     template<typename T>
-    JSValueRef CreateJSValue(JSContextRef ctx, const std::vector<T>& value) {
+    static JSValueRef CreateJSValue(JSContextRef ctx, const std::vector<T>& value) {
         auto* jsValues = new JSValueRef[value.size()];
         for(int i = 0; i < value.size(); i++) {
             jsValues[i] = CreateJSValue(ctx, value[i]);
@@ -257,6 +384,18 @@ public:
         return jsArray;
     }
 
+    // Structs declared with JSStructFields -> plain JS objects, one property per declared field
+    template<typename T>
+    static JSValueRef CreateJSStructValue(JSContextRef ctx, const T& value) {
+        const auto& names = JSStructPropertyNames<T>::get();
+        JSObjectRef object = JSObjectMake(ctx, nullptr, nullptr);
+        forEachJSField<T>([&](auto index, const auto& field) {
+            JSObjectSetProperty(ctx, object, names[index], CreateJSValue(ctx, value.*(field.member)),
+                                kJSPropertyAttributeNone, nullptr);
+        });
+        return object;
+    }
+
 
     //==============================================================================
 
@@ -265,9 +404,19 @@ public:
     // Helper function to convert different types of JSValueRef to C++ types
     template<typename T>
     static T GetJSValue(JSContextRef ctx, JSValueRef value) {
-        // Default implementation for unsupported types
-        DBG("JSInterop::GetJSValue: Unsupported type.");
-        return T();
+        if constexpr (IsJSStruct<T>::value) {
+            return GetJSStructValue<T>(ctx, value);
+        } else if constexpr (IsStdVector<T>::value) {
+            // Lists of any other supported type, including lists of structs
+            return GetJSValueList<typename T::value_type>(ctx, value);
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            // Any other number type (double, int64_t, ...)
+            return static_cast<T>(JSValueToNumber(ctx, value, nullptr));
+        } else {
+            // Default implementation for unsupported types
+            DBG("JSInterop::GetJSValue: Unsupported type.");
+            return T();
+        }
     }
 
     // float
@@ -288,12 +437,12 @@ public:
     // String
     template<>
     static juce::String GetJSValue<juce::String>(JSContextRef ctx, JSValueRef value) {
-        auto jsString = JSValueToStringCopy(ctx, value, nullptr);
+        auto jsString = CopyJSString(ctx, value);
         auto length = JSStringGetMaximumUTF8CStringSize(jsString);
         char* buffer = new char[length];
         JSStringGetUTF8CString(jsString, buffer, length);
         auto string = juce::String(buffer);
-        JSStringRelease(jsString);
+        ReleaseJSString(jsString);
         delete[] buffer;
         return string;
     }
@@ -322,8 +471,7 @@ public:
         JSObjectRef jsArray = JSValueToObject(ctx, value, nullptr);
         if (jsArray != nullptr) {
             auto length = static_cast<size_t>(JSValueToNumber(ctx, JSObjectGetProperty(ctx, jsArray,
-                                                                                         JSStringCreateWithUTF8CString(
-                                                                                                 "length"), nullptr),
+                                                                                         CreateJSString("length"), nullptr),
                                                                 nullptr));
             for (size_t i = 0; i < length; ++i) {
                 JSValueRef jsValue = JSObjectGetPropertyAtIndex(ctx, jsArray, static_cast<uint32_t>(i), nullptr);
@@ -335,6 +483,26 @@ public:
         return list;
     }
 
+    // Structs declared with JSStructFields. Properties that are missing on the JS object keep their
+    // default-constructed value.
+    template<typename T>
+    static T GetJSStructValue(JSContextRef ctx, JSValueRef value) {
+        T result{};
+        JSObjectRef object = JSValueToObject(ctx, value, nullptr);
+        if (object == nullptr) {
+            DBG("JSInterop::GetJSStructValue: Value is not an object.");
+            return result;
+        }
+        const auto& names = JSStructPropertyNames<T>::get();
+        forEachJSField<T>([&](auto index, const auto& field) {
+            using MemberType = std::decay_t<decltype(result.*(field.member))>;
+            JSValueRef property = JSObjectGetProperty(ctx, object, names[index], nullptr);
+            if (property != nullptr && !JSValueIsUndefined(ctx, property))
+                result.*(field.member) = GetJSValue<MemberType>(ctx, property);
+        });
+        return result;
+    }
+
 
     // ====================================================================
     // Helper functions for resolving multiple arguments of different types in JS->C++ callbacks
@@ -353,7 +521,9 @@ public:
     template<const size_t Index, typename... Args>
     typename std::enable_if<Index < sizeof...(Args), std::tuple<Args...>>::type
     static GetConvertedArgumentsHelper(JSContextRef ctx, const JSValueRef arguments[], size_t argumentCount, std::tuple<Args...>& tuple) {
-        auto value = GetJSValue<typename std::tuple_element<Index, std::tuple<Args...>>::type>(ctx, arguments[Index]);
+        // Arguments that were not passed from JS are treated as undefined
+        JSValueRef argument = Index < argumentCount ? arguments[Index] : JSValueMakeUndefined(ctx);
+        auto value = GetJSValue<typename std::tuple_element<Index, std::tuple<Args...>>::type>(ctx, argument);
         std::get<Index>(tuple) = value;
 
         return GetConvertedArgumentsHelper<Index + 1, Args...>(ctx, arguments, argumentCount, tuple);
@@ -362,10 +532,10 @@ public:
     /// \brief Gets the instance pointer from the JS object
     static JSInteropBase* GetInstance(JSContextRef ctx) {
         JSObjectRef globalObj = JSContextGetGlobalObject(ctx);
-        JSStringRef name = JSStringCreateWithUTF8CString("JSInterop");
+        JSStringRef name = CreateJSString("JSInterop");
         JSValueRef jsObj = JSObjectGetProperty(ctx, globalObj, name, nullptr);
         auto jsInteropJSObjRef = JSValueToObject(ctx, jsObj, nullptr);
-        JSStringRelease(name);
+        ReleaseJSString(name);
         auto* instance = static_cast<JSInteropBase*>(JSObjectGetPrivate(jsInteropJSObjRef));
 
         if(instance == nullptr) {
@@ -381,6 +551,14 @@ public:
     // Reference to the JUCE AudioProcessorValueTreeState and its listener
     juce::AudioProcessorValueTreeState& audioParams;
     juce::AudioProcessorValueTreeState::Listener& parent;
+    // Set in OnDOMReady, cleared when a new page starts loading
+    bool domReady = false;
+    // True while the editor is hidden, survives page reloads
+    bool pageHidden = false;
+    // Parameter values shared with the page as typed arrays
+    ParameterMirror parameterMirror;
+    // Cleared when the page calls DisableAPVTSPush(), set again for every new page
+    std::atomic<bool> apvtsPushEnabled { true };
 
 
 };
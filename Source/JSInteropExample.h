@@ -9,6 +9,39 @@
 
 #include "Ultralight/View.h"
 #include "JSInteropBase.h"
+#include "JSStructFields.h"
+#include "PluginProcessor.h"
+#include "PresetBrowser.h"
+
+// Example structs that are passed between C++ and JS as plain JS objects, see JSStructFields.h.
+// The fields are declared once below, nesting and vectors of structs are supported.
+struct ExampleEnvelope {
+    float attack = 0.0f;
+    float release = 0.0f;
+};
+
+struct ExamplePreset {
+    juce::String name;
+    int category = 0;
+    ExampleEnvelope envelope;
+    std::vector<ExampleEnvelope> stages;
+};
+
+template<>
+struct JSStructFields<ExampleEnvelope> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("attack", &ExampleEnvelope::attack),
+            jsField("release", &ExampleEnvelope::release));
+};
+
+template<>
+struct JSStructFields<ExamplePreset> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("name", &ExamplePreset::name),
+            jsField("category", &ExamplePreset::category),
+            jsField("envelope", &ExamplePreset::envelope),
+            jsField("stages", &ExamplePreset::stages));
+};
 
 // This class is an example of how to extend the JSInteropBase class.
 // You can either create extensions of the JSInteropBase class for each of your components, or add all your functions
@@ -19,7 +52,9 @@
 class JSInteropExample : public JSInteropBase {
 public:
     JSInteropExample(ultralight::View& inView, juce::AudioProcessorValueTreeState& params, juce::AudioProcessorValueTreeState::Listener& parentComponent)
-    : JSInteropBase(inView, params, parentComponent) {
+    : JSInteropBase(inView, params, parentComponent),
+    processor(dynamic_cast<AudioPluginAudioProcessor&>(params.processor)),
+    presetBrowser(processor.getPresetLibrary()) {
 
     }
 
@@ -50,6 +85,49 @@ public:
         };
         // 2) Register callback function in JS - now call OnMyButtonClick(int, String) from anywhere in your view's JS
         registerCppCallbackInJS("OnMyButtonClick", buttonClickCallback);
+
+        // Structs work the same way as primitive types once their fields are declared (see ExamplePreset above)
+        std::function<void(ExamplePreset)> presetEditedCallback = [](ExamplePreset preset) {
+            DBG("Preset edited: " << preset.name << " with " << (int) preset.stages.size() << " stages");
+        };
+        registerCppCallbackInJS("OnPresetEdited", presetEditedCallback);
+
+        // Callbacks can also return values, which JS receives synchronously. Use this for queries instead of
+        // requesting a value from JS and pushing it back with invokeMethod(), e.g. const text = GetParameterText("gain");
+        std::function<juce::String(juce::String)> getParameterTextCallback = [this](juce::String parameterID) {
+            if (auto* param = audioParams.getParameter(parameterID))
+                return param->getCurrentValueAsText();
+            return juce::String();
+        };
+        registerCppCallbackInJS("GetParameterText", getParameterTextCallback);
+
+        // ========================================================================================================
+        // Preset browsing (see PresetBrowser.h and Resources/script.js). Searches run on a background thread and
+        // report the number of results to PresetSearchResults() in JS, which then fetches the pages it displays.
+        // ========================================================================================================
+        std::function<void(juce::String, juce::String, juce::String)> presetSearch =
+                [this](juce::String query, juce::String category, juce::String tag) {
+            presetBrowser.search(query, category, tag, [this](int numResults) {
+                invokeMethod("PresetSearchResults", numResults);
+            });
+        };
+        registerCppCallbackInJS("PresetSearch", presetSearch);
+
+        std::function<int()> presetGetNumResults = [this]() { return presetBrowser.getNumResults(); };
+        registerCppCallbackInJS("PresetGetNumResults", presetGetNumResults);
+
+        std::function<std::vector<PresetInfo>(int, int)> presetGetPage = [this](int offset, int count) {
+            return presetBrowser.getPage(offset, count);
+        };
+        registerCppCallbackInJS("PresetGetPage", presetGetPage);
+
+        std::function<std::vector<juce::String>()> presetGetCategories = [this]() {
+            return presetBrowser.getCategories();
+        };
+        registerCppCallbackInJS("PresetGetCategories", presetGetCategories);
+
+        std::function<bool(int)> presetApply = [this](int index) { return processor.applyPreset(index); };
+        registerCppCallbackInJS("PresetApply", presetApply);
     }
 
     // Need to override this method to use JS functions in C++
@@ -71,7 +149,14 @@ public:
         invokeMethod("myJSFunction", myVector);
         // Mix
         invokeMethod("myJSFunction", 2, juce::String("Hello"), myVector);
+        // Structs (arrive in JS as { name: "Init", category: 1, envelope: { attack: ..., release: ... }, stages: [...] })
+        ExamplePreset preset{ "Init", 1, { 0.01f, 0.3f }, { { 0.1f, 0.2f }, { 0.3f, 0.4f } } };
+        invokeMethod("myJSFunction", preset);
     }
 
+private:
+    AudioPluginAudioProcessor& processor;
+    // Search results and paging of the preset library for this view
+    PresetBrowser presetBrowser;
 };
 #endif //ULTRALIGHTJUCE_JSINTEROPEXAMPLE_H
@@ -0,0 +1,106 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_JSSTRUCTFIELDS_H
+#define ULTRALIGHTJUCE_JSSTRUCTFIELDS_H
+
+#include <JavaScriptCore/JavaScript.h>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compile-time field descriptions for marshalling C++ structs to and from JS objects without going through an
+// intermediate text format (e.g. JSON). The conversion itself lives in JSInteropBase (CreateJSValue/GetJSValue),
+// this file only describes *which* fields a struct has and what they are called in JS.
+//
+// Usage: declare the fields of your struct once, at namespace scope, by specialising JSStructFields:
+//
+//     struct Envelope { float attack; float release; };
+//
+//     template<>
+//     struct JSStructFields<Envelope> {
+//         static constexpr auto fields = std::make_tuple(
+//                 jsField("attack", &Envelope::attack),
+//                 jsField("release", &Envelope::release));
+//     };
+//
+// Envelope can then be passed to invokeMethod(), used as an argument of registerCppCallbackInJS() callbacks, nested
+// inside other declared structs and used in std::vectors. On the JS side it is a plain object
+// ({ attack: 0.1, release: 0.5 }).
+
+/// \brief Describes a single member of a struct: its property name in JS and the pointer to the C++ member
+template<typename Struct, typename Member>
+struct JSField {
+    const char* name;
+    Member Struct::* member;
+};
+
+/// \brief Helper to create a JSField with deduced types, see the usage example at the top of this file
+template<typename Struct, typename Member>
+constexpr JSField<Struct, Member> jsField(const char* name, Member Struct::* member) {
+    return { name, member };
+}
+
+/// \brief Specialise this for every struct you want to pass between C++ and JS. The specialisation needs a
+/// static constexpr tuple of JSFields called "fields".
+template<typename T>
+struct JSStructFields {
+};
+
+/// \brief True if T has a JSStructFields specialisation
+template<typename T, typename = void>
+struct IsJSStruct : std::false_type {};
+
+template<typename T>
+struct IsJSStruct<T, std::void_t<decltype(JSStructFields<T>::fields)>> : std::true_type {};
+
+/// \brief True if T is a std::vector
+template<typename T>
+struct IsStdVector : std::false_type {};
+
+template<typename T, typename Allocator>
+struct IsStdVector<std::vector<T, Allocator>> : std::true_type {};
+
+/// \brief Number of declared fields of a struct
+template<typename T>
+constexpr std::size_t getNumJSFields() {
+    return std::tuple_size<std::decay_t<decltype(JSStructFields<T>::fields)>>::value;
+}
+
+/// \brief Calls function(index, field) for every declared field of T. The index is a std::integral_constant, so it
+/// can be used both at compile time and as a normal size_t.
+template<typename T, typename Function, std::size_t... Index>
+void forEachJSField(Function&& function, std::index_sequence<Index...>) {
+    (function(std::integral_constant<std::size_t, Index>{}, std::get<Index>(JSStructFields<T>::fields)), ...);
+}
+
+template<typename T, typename Function>
+void forEachJSField(Function&& function) {
+    forEachJSField<T>(std::forward<Function>(function), std::make_index_sequence<getNumJSFields<T>()>{});
+}
+
+/// \brief The JS property names of a declared struct. The JSStrings are created once per type (on first use) and
+/// then reused for every conversion. They are intentionally never released: JSStrings are not tied to a context, so
+/// they stay valid across views and page reloads for the lifetime of the process.
+template<typename T>
+struct JSStructPropertyNames {
+    static const std::array<JSStringRef, getNumJSFields<T>()>& get() {
+        static const std::array<JSStringRef, getNumJSFields<T>()> names = create();
+        return names;
+    }
+
+private:
+    static std::array<JSStringRef, getNumJSFields<T>()> create() {
+        std::array<JSStringRef, getNumJSFields<T>()> names{};
+        forEachJSField<T>([&names](auto index, const auto& field) {
+            names[index] = JSStringCreateWithUTF8CString(field.name);
+        });
+        return names;
+    }
+};
+
+#endif //ULTRALIGHTJUCE_JSSTRUCTFIELDS_H
@@ -0,0 +1,77 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_LOCKFREEHISTOGRAM_H
+#define ULTRALIGHTJUCE_LOCKFREEHISTOGRAM_H
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+/// \brief Histogram with linear buckets over [0, maxValue) that can be written from one thread (e.g. the audio
+/// thread) and read from another without locks. add() is wait-free apart from the compare-exchange loop for the
+/// maximum and never allocates. Values >= maxValue land in the last bucket (the maximum is still exact).
+/// Percentiles are accurate to one bucket width.
+template<size_t NumBuckets>
+class LockFreeHistogram {
+public:
+    explicit LockFreeHistogram(double maxValueIn) : maxValue(maxValueIn) {
+        reset();
+    }
+
+    void add(double value) noexcept {
+        const auto bucket = static_cast<size_t>(juce::jlimit(0.0, static_cast<double>(NumBuckets - 1),
+                                                             value / maxValue * static_cast<double>(NumBuckets)));
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sumMicroUnits.fetch_add(static_cast<uint64_t>(juce::jmax(0.0, value) * 1.0e6), std::memory_order_relaxed);
+
+        double previousMax = maximum.load(std::memory_order_relaxed);
+        while (value > previousMax && !maximum.compare_exchange_weak(previousMax, value, std::memory_order_relaxed)) {}
+    }
+
+    /// \brief Value below which the given percentage (0-100) of all values lie (upper edge of the bucket)
+    double getPercentile(double percent) const noexcept {
+        const auto total = count.load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0.0;
+        const auto threshold = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(total)));
+        uint64_t accumulated = 0;
+        for (size_t i = 0; i < NumBuckets; ++i) {
+            accumulated += buckets[i].load(std::memory_order_relaxed);
+            if (accumulated >= threshold)
+                return juce::jmin(getMax(), static_cast<double>(i + 1) * maxValue / static_cast<double>(NumBuckets));
+        }
+        return getMax();
+    }
+
+    double getMax() const noexcept { return maximum.load(std::memory_order_relaxed); }
+
+    double getMean() const noexcept {
+        const auto total = count.load(std::memory_order_relaxed);
+        return total == 0 ? 0.0 : static_cast<double>(sumMicroUnits.load(std::memory_order_relaxed)) * 1.0e-6 / static_cast<double>(total);
+    }
+
+    uint64_t getCount() const noexcept { return count.load(std::memory_order_relaxed); }
+
+    /// \brief Clears all values. Values added concurrently with a reset may be partially lost.
+    void reset() noexcept {
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        sumMicroUnits.store(0, std::memory_order_relaxed);
+        maximum.store(0.0, std::memory_order_relaxed);
+    }
+
+private:
+    const double maxValue;
+    std::array<std::atomic<uint32_t>, NumBuckets> buckets;
+    std::atomic<uint64_t> count { 0 };
+    std::atomic<uint64_t> sumMicroUnits { 0 };
+    std::atomic<double> maximum { 0.0 };
+};
+
+#endif //ULTRALIGHTJUCE_LOCKFREEHISTOGRAM_H
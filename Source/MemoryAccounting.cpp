@@ -0,0 +1,35 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#include "MemoryAccounting.h"
+#include "JSCPrivateAPI.h"
+
+#include <cmath>
+
+namespace {
+    double getNumberProperty (JSContextRef ctx, JSObjectRef object, const char* name)
+    {
+        JSStringRef propertyName = JSStringCreateWithUTF8CString (name);
+        const auto value = JSValueToNumber (ctx, JSObjectGetProperty (ctx, object, propertyName, nullptr), nullptr);
+        JSStringRelease (propertyName);
+        return std::isnan (value) ? 0.0 : value;
+    }
+}
+
+bool MemoryAccounting::getJSHeapStatistics (JSContextRef ctx, Snapshot& snapshot)
+{
+    const auto getMemoryUsageStatistics = JSCPrivateAPI::getMemoryUsageStatistics();
+    if (getMemoryUsageStatistics == nullptr || ctx == nullptr)
+        return false;
+
+    JSObjectRef statistics = getMemoryUsageStatistics (ctx);
+    if (statistics == nullptr)
+        return false;
+
+    snapshot.jsHeapBytes = getNumberProperty (ctx, statistics, "heapSize");
+    snapshot.jsHeapCapacityBytes = getNumberProperty (ctx, statistics, "heapCapacity");
+    snapshot.jsExtraMemoryBytes = getNumberProperty (ctx, statistics, "extraMemorySize");
+    snapshot.jsObjectCount = getNumberProperty (ctx, statistics, "objectCount");
+    return true;
+}
@@ -0,0 +1,119 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_MEMORYACCOUNTING_H
+#define ULTRALIGHTJUCE_MEMORYACCOUNTING_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+#include <JavaScriptCore/JavaScript.h>
+#include <deque>
+
+#include "JSInteropBase.h"
+#include "RendererMemoryManager.h"
+
+/// \brief Breaks down where the memory of an editor goes and keeps a history of samples, so leaks show up as trends.
+///
+/// A sample covers
+/// - the surface bitmaps of the editor's views (main view and inspector) and the JUCE images their pixels are copied to,
+/// - the JavaScriptCore heap of the main view's page,
+/// - the JS objects created by the interop layer (see JSInteropBase::InteropCounters),
+/// - the renderer-wide totals of the RendererMemoryManager.
+///
+/// The JS heap statistics come from JSGetMemoryUsageStatistics(), which is private JavaScriptCore API and not in the
+/// Ultralight headers. It is looked up in the WebCore library at runtime; if it isn't exported, jsHeapAvailable is false.
+///
+/// Message thread only.
+class MemoryAccounting {
+public:
+    struct Snapshot {
+        double timeSeconds = 0.0;               // Since the MemoryAccounting was created
+        // Editor
+        size_t viewBitmapBytes = 0;             // Surface of the main view
+        size_t inspectorBitmapBytes = 0;        // Surface of the inspector view
+        size_t imageBytes = 0;                  // JUCE image of the main view
+        size_t inspectorImageBytes = 0;         // JUCE image of the inspector
+        // JavaScriptCore heap of the main view's page
+        bool jsHeapAvailable = false;
+        double jsHeapBytes = 0.0;
+        double jsHeapCapacityBytes = 0.0;
+        double jsExtraMemoryBytes = 0.0;        // Memory held outside the heap, e.g. by ArrayBuffers
+        double jsObjectCount = 0.0;
+        // Interop layer (process-wide)
+        uint64_t interopStringsCreated = 0;
+        uint64_t interopStringsReleased = 0;
+        uint64_t interopFunctionWrappers = 0;
+        // Renderer (process-wide, see RendererMemoryManager)
+        size_t rendererViewBitmapBytes = 0;
+        size_t rendererEstimatedBytes = 0;
+        size_t processResidentBytes = 0;
+        int rendererViews = 0;
+    };
+
+    /// \brief Number of samples kept
+    static constexpr size_t HISTORY_LENGTH = 120;
+
+    /// \brief Takes a sample and adds it to the history
+    /// \param inspectorView May be null
+    Snapshot sample(ultralight::View& view, ultralight::View* inspectorView,
+                    const juce::Image& image, const juce::Image& inspectorImage,
+                    const RendererMemoryManager& rendererMemoryManager) {
+        Snapshot snapshot;
+        snapshot.timeSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        snapshot.viewBitmapBytes = getBitmapBytes(&view);
+        snapshot.inspectorBitmapBytes = getBitmapBytes(inspectorView);
+        snapshot.imageBytes = getImageBytes(image);
+        snapshot.inspectorImageBytes = getImageBytes(inspectorImage);
+
+        {
+            ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
+            snapshot.jsHeapAvailable = getJSHeapStatistics(context.get(), snapshot);
+        }
+
+        const auto& counters = JSInteropBase::getInteropCounters();
+        snapshot.interopStringsCreated = counters.jsStringsCreated.load(std::memory_order_relaxed);
+        snapshot.interopStringsReleased = counters.jsStringsReleased.load(std::memory_order_relaxed);
+        snapshot.interopFunctionWrappers = counters.functionWrappersCreated.load(std::memory_order_relaxed);
+
+        const auto usage = rendererMemoryManager.getUsage();
+        snapshot.rendererViewBitmapBytes = usage.viewBitmapBytes;
+        snapshot.rendererEstimatedBytes = usage.estimatedRendererBytes;
+        snapshot.processResidentBytes = usage.processResidentBytes;
+        snapshot.rendererViews = usage.numViews;
+
+        history.push_back(snapshot);
+        if (history.size() > HISTORY_LENGTH)
+            history.pop_front();
+        return snapshot;
+    }
+
+    /// \brief Samples taken so far, oldest first (at most HISTORY_LENGTH)
+    const std::deque<Snapshot>& getHistory() const { return history; }
+
+    /// \brief Fills the jsHeap* fields from JSGetMemoryUsageStatistics(). Implemented in MemoryAccounting.cpp.
+    /// \return false if the function isn't available
+    static bool getJSHeapStatistics(JSContextRef ctx, Snapshot& snapshot);
+
+private:
+    static size_t getBitmapBytes(ultralight::View* view) {
+        if (view == nullptr)
+            return 0;
+        if (auto* surface = view->surface())
+            return static_cast<size_t>(surface->row_bytes()) * surface->height();
+        return static_cast<size_t>(view->width()) * view->height() * 4;
+    }
+
+    static size_t getImageBytes(const juce::Image& image) {
+        if (!image.isValid())
+            return 0;
+        return static_cast<size_t>(image.getWidth()) * static_cast<size_t>(image.getHeight())
+               * static_cast<size_t>(image.getFormat() == juce::Image::SingleChannel ? 1 : 4);
+    }
+
+    const double startTime = juce::Time::getMillisecondCounterHiRes();
+    std::deque<Snapshot> history;
+};
+
+#endif //ULTRALIGHTJUCE_MEMORYACCOUNTING_H
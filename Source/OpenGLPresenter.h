@@ -0,0 +1,280 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_OPENGLPRESENTER_H
+#define ULTRALIGHTJUCE_OPENGLPRESENTER_H
+
+#include <JuceHeader.h>
+#include <juce_opengl/juce_opengl.h>
+#include <atomic>
+#include <cstring>
+
+/// \brief Presents the pixels of an Ultralight View through OpenGL instead of juce::Graphics::drawImage().
+///
+/// The software path copies the whole surface into a new juce::Image every frame and lets JUCE's software renderer
+/// scale it. Here only the dirty rectangle of the surface is copied (into a staging buffer, on the Message thread),
+/// and streamed into a persistent texture on the GL thread through two alternating pixel buffer objects
+/// (glMapBufferRange + glTexSubImage2D from the PBO). Scaling to the component and converting Ultralight's BGRA are
+/// done by a trivial shader.
+///
+/// Ultralight must only be called on the Message thread, so the component's paint() isn't used when the presenter is
+/// attached: the component renders its View from the Message thread and hands the pixels to upload().
+/// Needs OpenGL 3.2 (Mesa's llvmpipe is fine, see the README). If the shader can't be created, or no context has come
+/// up CONTEXT_TIMEOUT_MS after the component was first shown (JUCE then never calls newOpenGLContextCreated()),
+/// hasFailed() turns true and the component should fall back to the software path.
+class OpenGLPresenter : private juce::OpenGLRenderer, private juce::ComponentListener {
+public:
+    explicit OpenGLPresenter(juce::Component& targetIn) : target(targetIn) {
+        updateTargetSize();
+        target.addComponentListener(this);
+        context.setOpenGLVersionRequired(juce::OpenGLContext::openGL3_2);
+        context.setRenderer(this);
+        // Nothing to paint with juce::Graphics, the View is drawn by renderOpenGL()
+        context.setComponentPaintingEnabled(false);
+        context.setContinuousRepainting(false);
+        context.attachTo(target);
+    }
+
+    ~OpenGLPresenter() override {
+        target.removeComponentListener(this);
+        context.detach();
+    }
+
+    /// \brief Copies the dirty part of the View's pixels and schedules a GL frame (Message thread)
+    /// \param pixels The locked pixels of the View's bitmap (BGRA, premultiplied alpha)
+    /// \param dirty The dirty bounds of the surface, the whole bitmap is copied if its size changed
+    void upload(const void* pixels, uint32_t width, uint32_t height, uint32_t stride, juce::Rectangle<int> dirty) {
+        const juce::Rectangle<int> bounds(static_cast<int>(width), static_cast<int>(height));
+        {
+            const juce::ScopedLock lock(stagingLock);
+            targetSize = target.getLocalBounds();
+            if (bounds != stagingBounds) {
+                staging.allocate(width * height * 4, false);
+                stagingBounds = bounds;
+                dirty = bounds;
+            }
+            dirty = dirty.getIntersection(bounds);
+            if (dirty.isEmpty())
+                return;
+
+            const auto rowBytes = static_cast<size_t>(dirty.getWidth()) * 4;
+            for (int y = dirty.getY(); y < dirty.getBottom(); ++y)
+                std::memcpy(staging.get() + (static_cast<size_t>(y) * width + static_cast<size_t>(dirty.getX())) * 4,
+                            static_cast<const uint8_t*>(pixels) + static_cast<size_t>(y) * stride + static_cast<size_t>(dirty.getX()) * 4,
+                            rowBytes);
+            pendingDirty = pendingDirty.isEmpty() ? dirty : pendingDirty.getUnion(dirty);
+        }
+        context.triggerRepaint();
+    }
+
+    /// \brief Draws the last uploaded frame again, e.g. after the component was resized
+    void repaint() {
+        context.triggerRepaint();
+    }
+
+    /// \brief How long a shown component may wait for its context before OpenGL counts as unavailable
+    static constexpr double CONTEXT_TIMEOUT_MS = 2000.0;
+
+    /// \brief True if OpenGL isn't usable, the component should present in software instead. Message thread, call it
+    /// regularly (e.g. from a timer), it also detects a context that never came up.
+    bool hasFailed() {
+        if (failed.load() || contextCreated.load())
+            return failed.load();
+        // The context is created asynchronously once the component is on screen, so only wait while it is
+        if (!target.isShowing()) {
+            waitingSince = 0.0;
+            return false;
+        }
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        if (waitingSince <= 0.0) {
+            waitingSince = now;
+        } else if (now - waitingSince > CONTEXT_TIMEOUT_MS) {
+            DBG("OpenGLPresenter: no OpenGL 3.2 context after " << CONTEXT_TIMEOUT_MS << " ms");
+            failed = true;
+        }
+        return failed.load();
+    }
+
+private:
+    // ================================== Message thread ==================================
+    void componentMovedOrResized(juce::Component&, bool, bool wasResized) override {
+        if (!wasResized)
+            return;
+        updateTargetSize();
+        context.triggerRepaint();
+    }
+
+    /// \brief Records the component's size for the GL thread, which must not read it from the component
+    void updateTargetSize() {
+        const juce::ScopedLock lock(stagingLock);
+        targetSize = target.getLocalBounds();
+    }
+
+    // ================================== GL thread ==================================
+    void newOpenGLContextCreated() override {
+        using namespace juce::gl;
+        contextCreated = true;
+        shader = std::make_unique<juce::OpenGLShaderProgram>(context);
+        const bool compiled = shader->addVertexShader(juce::OpenGLHelpers::translateVertexShaderToV3(R"GLSL(
+attribute vec2 position;
+varying vec2 textureCoordinate;
+void main() {
+    // The first row of the texture is the top row of the View
+    textureCoordinate = vec2(position.x * 0.5 + 0.5, 0.5 - position.y * 0.5);
+    gl_Position = vec4(position, 0.0, 1.0);
+})GLSL"))
+                && shader->addFragmentShader(juce::OpenGLHelpers::translateFragmentShaderToV3(R"GLSL(
+varying vec2 textureCoordinate;
+uniform sampler2D surface;
+void main() {
+    // Ultralight's pixels are BGRA, uploaded as RGBA
+    gl_FragColor = texture2D(surface, textureCoordinate).bgra;
+})GLSL"))
+                && shader->link();
+        if (!compiled) {
+            DBG("OpenGLPresenter: " << shader->getLastError());
+            shader.reset();
+            failed = true;
+            return;
+        }
+        positionAttribute = glGetAttribLocation(shader->getProgramID(), "position");
+        surfaceUniform = glGetUniformLocation(shader->getProgramID(), "surface");
+
+        // Full-screen quad (triangle strip)
+        const GLfloat quad[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+        glGenVertexArrays(1, &vertexArray);
+        glBindVertexArray(vertexArray);
+        glGenBuffers(1, &vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(static_cast<GLuint>(positionAttribute));
+        glVertexAttribPointer(static_cast<GLuint>(positionAttribute), 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindVertexArray(0);
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        textureBounds = {};
+
+        glGenBuffers(2, pixelBuffers);
+
+        // A new context (e.g. after the component moved to another window) starts with an empty texture
+        const juce::ScopedLock lock(stagingLock);
+        pendingDirty = stagingBounds;
+    }
+
+    void renderOpenGL() override {
+        using namespace juce::gl;
+        juce::Rectangle<int> viewport;
+        {
+            const juce::ScopedLock lock(stagingLock);
+            viewport = targetSize;
+        }
+        const auto scale = static_cast<float>(context.getRenderingScale());
+        glViewport(0, 0, juce::roundToInt(scale * static_cast<float>(viewport.getWidth())),
+                   juce::roundToInt(scale * static_cast<float>(viewport.getHeight())));
+        juce::OpenGLHelpers::clear(juce::Colours::black);
+        if (shader == nullptr)
+            return;
+
+        {
+            const juce::ScopedLock lock(stagingLock);
+            if (!pendingDirty.isEmpty()) {
+                if (textureBounds != stagingBounds) {
+                    // (Re)allocate the texture, the whole staging buffer is uploaded into it
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, stagingBounds.getWidth(), stagingBounds.getHeight(), 0,
+                                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                    textureBounds = stagingBounds;
+                    pendingDirty = stagingBounds;
+                }
+                streamToTexture(pendingDirty);
+                pendingDirty = {};
+            }
+        }
+        if (textureBounds.isEmpty())
+            return;
+
+        // The View's pixels are premultiplied
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        shader->use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glUniform1i(surfaceUniform, 0);
+        glBindVertexArray(vertexArray);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+    }
+
+    void openGLContextClosing() override {
+        using namespace juce::gl;
+        if (shader == nullptr)
+            return;
+        glDeleteBuffers(2, pixelBuffers);
+        glDeleteTextures(1, &texture);
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteVertexArrays(1, &vertexArray);
+        shader.reset();
+        textureBounds = {};
+    }
+
+    /// \brief Copies a rectangle of the staging buffer into the next PBO and from there into the texture.
+    /// The PBO is orphaned first, so the driver never waits for the previous upload to finish.
+    void streamToTexture(juce::Rectangle<int> area) {
+        using namespace juce::gl;
+        const auto rowBytes = static_cast<size_t>(area.getWidth()) * 4;
+        const auto size = rowBytes * static_cast<size_t>(area.getHeight());
+        const auto stagingWidth = static_cast<size_t>(stagingBounds.getWidth());
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+        nextPixelBuffer ^= 1;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+        auto* destination = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size),
+                                                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (destination != nullptr) {
+            for (int y = 0; y < area.getHeight(); ++y)
+                std::memcpy(destination + static_cast<size_t>(y) * rowBytes,
+                            staging.get() + ((static_cast<size_t>(area.getY() + y)) * stagingWidth + static_cast<size_t>(area.getX())) * 4,
+                            rowBytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            // Reads from the bound PBO (offset 0) instead of client memory
+            glTexSubImage2D(GL_TEXTURE_2D, 0, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                            GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    juce::Component& target;
+    juce::OpenGLContext context;
+    std::atomic<bool> failed { false };
+    std::atomic<bool> contextCreated { false };    // Set on the GL thread, read by hasFailed()
+    double waitingSince = 0.0;                      // When the shown component started waiting for its context
+
+    // Copy of the View's pixels (tightly packed BGRA) and the part of it that hasn't been uploaded yet, and the
+    // component's size as of the Message thread (the GL thread reads this copy)
+    juce::CriticalSection stagingLock;
+    juce::Rectangle<int> targetSize;
+    juce::HeapBlock<uint8_t> staging;
+    juce::Rectangle<int> stagingBounds;
+    juce::Rectangle<int> pendingDirty;
+
+    // GL thread only (GL object names are GLuint, locations GLint)
+    std::unique_ptr<juce::OpenGLShaderProgram> shader;
+    int positionAttribute = -1;
+    int surfaceUniform = -1;
+    unsigned int vertexArray = 0;
+    unsigned int vertexBuffer = 0;
+    unsigned int texture = 0;
+    unsigned int pixelBuffers[2] = { 0, 0 };
+    int nextPixelBuffer = 0;
+    juce::Rectangle<int> textureBounds;
+};
+
+#endif //ULTRALIGHTJUCE_OPENGLPRESENTER_H
@@ -0,0 +1,60 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_PAGEVISIBILITY_H
+#define ULTRALIGHTJUCE_PAGEVISIBILITY_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+
+/// \brief Tells a page whether its editor is visible, so it can stop animating while nobody sees it.
+///
+/// Ultralight doesn't know about the editor being hidden: requestAnimationFrame() keeps firing whenever any view of
+/// the shared renderer is updated. install() (called from OnWindowObjectReady, before the page's scripts run) wraps
+/// requestAnimationFrame so that callbacks requested while hidden are held back and run once, in the first frame after
+/// the page becomes visible again. document.hidden/visibilityState and the visibilitychange event work as in a
+/// browser, so pages can also pause timers of their own.
+class PageVisibility {
+public:
+    static void install(ultralight::View& view) {
+        evaluate(view, R"JS((function() {
+    if (window.__setPageHidden) return;
+    let hidden = false;
+    let held = [];
+    const nativeRequest = window.requestAnimationFrame.bind(window);
+    const nativeCancel = window.cancelAnimationFrame.bind(window);
+    // Held callbacks get negative ids, so they can still be cancelled
+    window.requestAnimationFrame = (callback) => hidden ? -held.push(callback) : nativeRequest(callback);
+    window.cancelAnimationFrame = (id) => { if (id < 0) held[-id - 1] = null; else nativeCancel(id); };
+    Object.defineProperty(document, 'hidden', { get: () => hidden, configurable: true });
+    Object.defineProperty(document, 'visibilityState', { get: () => hidden ? 'hidden' : 'visible', configurable: true });
+    window.__setPageHidden = (value) => {
+        if (value === hidden) return;
+        hidden = value;
+        document.dispatchEvent(new Event('visibilitychange'));
+        if (!hidden) {
+            const callbacks = held;
+            held = [];
+            callbacks.forEach((callback) => { if (callback) nativeRequest(callback); });
+        }
+    };
+})())JS");
+    }
+
+    /// \brief Hides or shows the page (install() must have run for the current page)
+    static void setHidden(ultralight::View& view, bool hidden) {
+        evaluate(view, hidden ? "window.__setPageHidden && window.__setPageHidden(true)"
+                              : "window.__setPageHidden && window.__setPageHidden(false)");
+    }
+
+private:
+    static void evaluate(ultralight::View& view, const char* script) {
+        ultralight::String exception;
+        view.EvaluateScript(script, &exception);
+        if (!exception.empty())
+            DBG("PageVisibility: " << exception.utf8().data());
+    }
+};
+
+#endif //ULTRALIGHTJUCE_PAGEVISIBILITY_H
@@ -0,0 +1,171 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_PARAMETERMIRROR_H
+#define ULTRALIGHTJUCE_PARAMETERMIRROR_H
+
+#include <JuceHeader.h>
+#include <JavaScriptCore/JSRetainPtr.h>
+#include <JavaScriptCore/JavaScript.h>
+#include <memory>
+#include <vector>
+
+#include "HostTransport.h"
+
+/// \brief Mirrors the normalized values of all parameters of a processor (plus the host transport) into memory that
+/// the page reads directly as a Float32Array, without a message per change.
+///
+/// install() (called from OnWindowObjectReady) defines window.ParameterMirror in the page:
+/// - values: Float32Array, the normalized parameter values in the order of AudioProcessor::getParameters(), followed by
+///   the transport values (see TransportValue),
+/// - dirty: Uint32Array, bit i (dirty[i >> 5] & (1 << (i & 31))) is set if values[i] changed since the page last
+///   cleared it. The page acknowledges the changes it has read by clearing the bits (e.g. dirty.fill(0)); until then
+///   they accumulate, so no change is lost in frames without a requestAnimationFrame() callback,
+/// - ids: the parameter IDs, index: value index by parameter ID or transport name (e.g. index.gain, index.bpm).
+/// Both arrays share their memory with this class (JSObjectMakeTypedArrayWithBytesNoCopy). snapshot() updates it in
+/// place once per frame, right before Renderer::Update(), so requestAnimationFrame() callbacks always see the current
+/// values.
+///
+/// The memory is reference counted between this class and the JS arrays, so it stays valid for pages that outlive
+/// the mirror. Message thread only (JS runs there as well, so no locking is needed).
+class ParameterMirror {
+public:
+    /// \brief Transport values after the parameters (booleans are 0 or 1)
+    enum TransportValue {
+        Bpm = 0,
+        PpqPosition,
+        TimeSeconds,
+        BarStartPpq,
+        TimeSigNumerator,
+        TimeSigDenominator,
+        Playing,
+        Recording,
+        Looping,
+        NumTransportValues
+    };
+
+    explicit ParameterMirror(juce::AudioProcessor& processor)
+            : parameters(processor.getParameters()),
+              memory(std::make_shared<Memory>(static_cast<size_t>(parameters.size()) + NumTransportValues)) {
+    }
+
+    /// \brief The transport mirrored after the parameters (e.g. the processor's, updated in processBlock)
+    void setTransport(const HostTransport* transportIn) { transport = transportIn; }
+
+    /// \brief Copies the current values into the mirror and marks the changed ones as dirty (once per frame). Only
+    /// sets bits, clearing them is up to the page.
+    /// \return true if any value changed
+    bool snapshot() {
+        auto& values = memory->values;
+        bool changed = false;
+        // Everything counts as changed in the first frame of a page
+        const bool markAll = markAllDirty;
+        markAllDirty = false;
+        auto set = [&](size_t index, float value) {
+            if (values[index] == value && !markAll)
+                return;
+            values[index] = value;
+            memory->dirty[index >> 5] |= 1u << (index & 31);
+            changed = true;
+        };
+
+        for (int i = 0; i < parameters.size(); ++i)
+            set(static_cast<size_t>(i), parameters[i]->getValue());
+
+        if (transport != nullptr) {
+            const auto state = transport->get();
+            const auto offset = static_cast<size_t>(parameters.size());
+            set(offset + Bpm, static_cast<float>(state.bpm));
+            set(offset + PpqPosition, static_cast<float>(state.ppqPosition));
+            set(offset + TimeSeconds, static_cast<float>(state.timeSeconds));
+            set(offset + BarStartPpq, static_cast<float>(state.barStartPpq));
+            set(offset + TimeSigNumerator, static_cast<float>(state.timeSigNumerator));
+            set(offset + TimeSigDenominator, static_cast<float>(state.timeSigDenominator));
+            set(offset + Playing, state.playing ? 1.0f : 0.0f);
+            set(offset + Recording, state.recording ? 1.0f : 0.0f);
+            set(offset + Looping, state.looping ? 1.0f : 0.0f);
+        }
+        return changed;
+    }
+
+    /// \brief Defines window.ParameterMirror in the page (call from OnWindowObjectReady with the locked context)
+    void install(JSContextRef ctx) {
+        // ids and index are plain data, built as JSON
+        auto* description = new juce::DynamicObject();
+        juce::Array<juce::var> ids;
+        auto* index = new juce::DynamicObject();
+        for (int i = 0; i < parameters.size(); ++i) {
+            const auto id = getParameterID(*parameters[i], i);
+            ids.add(id);
+            index->setProperty(id, i);
+        }
+        static const char* transportNames[NumTransportValues] = {
+                "bpm", "ppqPosition", "timeSeconds", "barStartPpq", "timeSigNumerator", "timeSigDenominator",
+                "playing", "recording", "looping" };
+        for (int i = 0; i < NumTransportValues; ++i)
+            index->setProperty(transportNames[i], parameters.size() + i);
+        description->setProperty("ids", ids);
+        description->setProperty("index", juce::var(index));
+        description->setProperty("transportOffset", parameters.size());
+
+        JSRetainPtr<JSStringRef> json = adopt(JSStringCreateWithUTF8CString(
+                juce::JSON::toString(juce::var(description), true).toRawUTF8()));
+        JSValueRef mirrorValue = JSValueMakeFromJSONString(ctx, json.get());
+        if (mirrorValue == nullptr || !JSValueIsObject(ctx, mirrorValue)) {
+            DBG("ParameterMirror: couldn't create the mirror object");
+            return;
+        }
+        JSObjectRef mirror = JSValueToObject(ctx, mirrorValue, nullptr);
+
+        setProperty(ctx, mirror, "values", makeTypedArray(ctx, kJSTypedArrayTypeFloat32Array, memory->values.data(),
+                                                          memory->values.size() * sizeof(float)));
+        setProperty(ctx, mirror, "dirty", makeTypedArray(ctx, kJSTypedArrayTypeUint32Array, memory->dirty.data(),
+                                                         memory->dirty.size() * sizeof(uint32_t)));
+        setProperty(ctx, JSContextGetGlobalObject(ctx), "ParameterMirror", mirror);
+        markAllDirty = true;
+    }
+
+    /// \brief Number of mirrored values (parameters and transport)
+    size_t getNumValues() const { return memory->values.size(); }
+
+private:
+    struct Memory {
+        explicit Memory(size_t numValues) : values(numValues, 0.0f), dirty((numValues + 31) / 32, 0u) {}
+        std::vector<float> values;
+        std::vector<uint32_t> dirty;
+    };
+
+    static juce::String getParameterID(juce::AudioProcessorParameter& parameter, int index) {
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(&parameter))
+            return withID->getParameterID();
+        return "parameter" + juce::String(index);
+    }
+
+    /// \brief A typed array on our memory, holding a reference to it until JS collects the array
+    JSValueRef makeTypedArray(JSContextRef ctx, JSTypedArrayType type, void* bytes, size_t byteLength) {
+        auto* reference = new std::shared_ptr<Memory>(memory);
+        JSValueRef exception = nullptr;
+        JSObjectRef array = JSObjectMakeTypedArrayWithBytesNoCopy(ctx, type, bytes, byteLength,
+                [](void*, void* context) { delete static_cast<std::shared_ptr<Memory>*>(context); },
+                reference, &exception);
+        if (array == nullptr || exception != nullptr) {
+            DBG("ParameterMirror: couldn't create a typed array");
+            delete reference;
+            return JSValueMakeUndefined(ctx);
+        }
+        return array;
+    }
+
+    static void setProperty(JSContextRef ctx, JSObjectRef object, const char* name, JSValueRef value) {
+        JSRetainPtr<JSStringRef> propertyName = adopt(JSStringCreateWithUTF8CString(name));
+        JSObjectSetProperty(ctx, object, propertyName.get(), value, kJSPropertyAttributeReadOnly, nullptr);
+    }
+
+    const juce::Array<juce::AudioProcessorParameter*>& parameters;
+    const HostTransport* transport = nullptr;
+    std::shared_ptr<Memory> memory;
+    bool markAllDirty = true;
+};
+
+#endif //ULTRALIGHTJUCE_PARAMETERMIRROR_H
@@ -0,0 +1,152 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_PARAMETERSMOOTHER_H
+#define ULTRALIGHTJUCE_PARAMETERSMOOTHER_H
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <vector>
+
+/// \brief Linear smoothing for any number of parameters, used in processBlock to avoid zipper noise from UI drags
+/// and automation steps.
+/// All smoothed parameters are stored in a structure-of-arrays layout (current value, target, step size and
+/// remaining steps each in their own array). Per-sample ramps are generated with JUCE's SIMD FloatVectorOperations,
+/// and parameters that are at rest are skipped entirely - for them getRamp() returns nullptr and the DSP can use
+/// getCurrentValue() as a constant instead.
+///
+/// Usage:
+/// 1) addParameter() for every parameter in the processor constructor
+/// 2) prepare() in prepareToPlay()
+/// 3) process() once per block (at most getMaximumBlockSize() samples), then read getRamp()/getCurrentValue()
+class ParameterSmoother {
+public:
+    /// \brief Adds a parameter to smooth. Call this before prepare(), i.e. not from the audio thread.
+    /// \param source The raw parameter value, e.g. from AudioProcessorValueTreeState::getRawParameterValue()
+    /// \param rampLengthSeconds How long it takes to move to a new target value
+    /// \return The index of the parameter in this smoother
+    int addParameter(std::atomic<float>* source, double rampLengthSeconds = 0.05) {
+        jassert(source != nullptr);
+        sources.push_back(source);
+        rampLengthsSeconds.push_back(rampLengthSeconds);
+        currentValues.push_back(source->load());
+        targetValues.push_back(source->load());
+        stepSizes.push_back(0.0f);
+        stepsRemaining.push_back(0);
+        rampLengthsInSamples.push_back(0);
+        movedInLastBlock.push_back(0);
+        activeParameters.reserve(sources.size());
+        return static_cast<int>(sources.size()) - 1;
+    }
+
+    /// \brief Allocates the ramp buffers and snaps all parameters to their current values
+    void prepare(double sampleRate, int maximumBlockSize) {
+        maxBlockSize = juce::jmax(1, maximumBlockSize);
+        for (size_t i = 0; i < sources.size(); ++i)
+            rampLengthsInSamples[i] = juce::jmax(1, juce::roundToInt(rampLengthsSeconds[i] * sampleRate));
+
+        // One ramp per parameter, AudioBuffer keeps the channels aligned for the vector operations
+        ramps.setSize(juce::jmax(1, static_cast<int>(sources.size())), maxBlockSize, false, true, false);
+        // 1, 2, 3, ... used to build ramps as start + step * index
+        sampleIndices.resize(static_cast<size_t>(maxBlockSize));
+        for (int i = 0; i < maxBlockSize; ++i)
+            sampleIndices[static_cast<size_t>(i)] = static_cast<float>(i + 1);
+
+        reset();
+    }
+
+    /// \brief Jumps all parameters to their current target without ramping
+    void reset() {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            targetValues[i] = currentValues[i] = sources[i]->load();
+            stepsRemaining[i] = 0;
+            stepSizes[i] = 0.0f;
+            movedInLastBlock[i] = 0;
+        }
+        activeParameters.clear();
+    }
+
+    /// \brief Reads the latest targets and advances all moving parameters by numSamples. Call once per block on the
+    /// audio thread, before reading the ramps. Does not allocate.
+    void process(int numSamples) {
+        jassert(numSamples <= maxBlockSize);
+        numSamples = juce::jmin(numSamples, maxBlockSize);
+        for (int active : activeParameters)
+            movedInLastBlock[static_cast<size_t>(active)] = 0;
+        activeParameters.clear();
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            // Start a new ramp if the target moved
+            const float newTarget = sources[i]->load(std::memory_order_relaxed);
+            if (newTarget != targetValues[i]) {
+                targetValues[i] = newTarget;
+                stepsRemaining[i] = rampLengthsInSamples[i];
+                stepSizes[i] = (newTarget - currentValues[i]) / static_cast<float>(stepsRemaining[i]);
+            }
+
+            // At rest: nothing to do
+            if (stepsRemaining[i] == 0)
+                continue;
+
+            activeParameters.push_back(static_cast<int>(i));
+            movedInLastBlock[i] = 1;
+            float* ramp = ramps.getWritePointer(static_cast<int>(i));
+            const int rampSamples = juce::jmin(numSamples, stepsRemaining[i]);
+
+            // ramp[n] = current + step * (n + 1)
+            juce::FloatVectorOperations::copyWithMultiply(ramp, sampleIndices.data(), stepSizes[i], rampSamples);
+            juce::FloatVectorOperations::add(ramp, currentValues[i], rampSamples);
+
+            stepsRemaining[i] -= rampSamples;
+            if (stepsRemaining[i] == 0) {
+                // Finished within this block: land exactly on the target and hold it
+                juce::FloatVectorOperations::fill(ramp + rampSamples - 1, targetValues[i], numSamples - rampSamples + 1);
+                currentValues[i] = targetValues[i];
+            } else {
+                currentValues[i] = ramp[rampSamples - 1];
+            }
+        }
+    }
+
+    /// \brief The per-sample values of the parameter for the last processed block, or nullptr if the parameter is
+    /// at rest (then use getCurrentValue())
+    const float* getRamp(int index) const {
+        return isSmoothing(index) ? ramps.getReadPointer(index) : nullptr;
+    }
+
+    /// \brief True if the parameter moved during the last processed block
+    bool isSmoothing(int index) const {
+        return movedInLastBlock[static_cast<size_t>(index)] != 0;
+    }
+
+    /// \brief The value of the parameter at the end of the last processed block
+    float getCurrentValue(int index) const {
+        return currentValues[static_cast<size_t>(index)];
+    }
+
+    /// \brief The parameters that moved during the last processed block
+    const std::vector<int>& getActiveParameters() const { return activeParameters; }
+
+    int getMaximumBlockSize() const { return maxBlockSize; }
+
+private:
+    // Structure-of-arrays state, one entry per parameter
+    std::vector<std::atomic<float>*> sources;
+    std::vector<double> rampLengthsSeconds;
+    std::vector<float> currentValues;
+    std::vector<float> targetValues;
+    std::vector<float> stepSizes;
+    std::vector<int> stepsRemaining;
+    std::vector<int> rampLengthsInSamples;
+    std::vector<uint8_t> movedInLastBlock;
+
+    // Per-sample ramps of the last block, one channel per parameter
+    juce::AudioBuffer<float> ramps;
+    std::vector<float> sampleIndices;
+    // Indices of the parameters that moved during the last block (capacity reserved up front)
+    std::vector<int> activeParameters;
+    int maxBlockSize = 0;
+};
+
+#endif //ULTRALIGHTJUCE_PARAMETERSMOOTHER_H
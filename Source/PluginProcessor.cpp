@@ -1,7 +1,21 @@
 #include "PluginProcessor.h"
 #include "Config.h"
 #include "PluginEditor.h"
+#include "StateSerializer.h"
+#include "SharedResourceCache.h"
+#include "SpriteAtlas.h"
+#include "TraceEvents.h"
+#if ! ULTRALIGHTJUCE_LOOSE_RESOURCES
+ #include "ResourceFileSystem.h"
+#endif
+// Generated by juce_add_binary_data() from the Presets folder (see CMakeLists.txt)
+#include <FactoryPresets.h>
+#if ULTRALIGHTJUCE_PRERENDER_SPRITES
+ // Generated by juce_add_binary_data() from the atlases pre-rendered by the SpriteAtlasBuilder (see CMakeLists.txt)
+ #include <SpriteResources.h>
+#endif
 #include "Ultralight/Renderer.h"
+#include <mutex>
 
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
@@ -13,6 +27,10 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
         std::make_unique<juce::AudioParameterFloat>("gain", "Gain", 0.0f, 1.0f, 0.5f)
 })
 {
+    ++NUM_INSTANCES_CREATED;
+
+    // Smooth all parameters that are applied per sample in processBlock
+    gainSmootherIndex = smoother.addParameter(parameters.getRawParameterValue("gain"));
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
@@ -26,6 +44,9 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 
     DBG(sampleRate);
     DBG(samplesPerBlock);
+
+    smoother.prepare(sampleRate, samplesPerBlock);
+    loadMeter.prepare(sampleRate, samplesPerBlock);
 }
 
 
@@ -33,13 +54,28 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
-
-    // Get the current value of the "gain" parameter
-    float gain = *parameters.getRawParameterValue("gain");
-    // Apply the gain to the audio buffer
-    buffer.applyGain(gain);
-
+    ULJ_TRACE_THREAD_NAME("Audio");
+    ULJ_TRACE_SCOPE("processBlock");
+    AudioLoadMeter::ScopedMeasurement loadMeasurement (loadMeter, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
+    hostTransport.update (getPlayHead());
+
+    // Hosts may send blocks larger than announced in prepareToPlay, so process in chunks the smoother can handle
+    const int chunkSize = smoother.getMaximumBlockSize();
+    if (chunkSize <= 0)
+        return; // prepareToPlay has not been called yet
+    for (int start = 0; start < buffer.getNumSamples(); start += chunkSize) {
+        const int numSamples = juce::jmin(chunkSize, buffer.getNumSamples() - start);
+        smoother.process(numSamples);
+
+        // Apply the gain to the audio buffer: per sample while the parameter moves, as a constant when it is at rest
+        if (const float* gainRamp = smoother.getRamp(gainSmootherIndex)) {
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                juce::FloatVectorOperations::multiply(buffer.getWritePointer(channel, start), gainRamp, numSamples);
+        } else {
+            buffer.applyGain(start, numSamples, smoother.getCurrentValue(gainSmootherIndex));
+        }
+    }
 }
 
 
@@ -94,31 +130,51 @@ double AudioPluginAudioProcessor::getTailLengthSeconds() const
 
 int AudioPluginAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    // NB: some hosts don't cope very well if you tell them there are 0 programs,
     // so this should be at least 1, even if you're not really implementing programs.
+    const auto library = getPresetLibrary();
+    return library != nullptr ? juce::jmax(1, library->size()) : 1;
 }
 
 int AudioPluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void AudioPluginAudioProcessor::setCurrentProgram (int index)
 {
-    juce::ignoreUnused (index);
+    applyPreset(index);
 }
 
 const juce::String AudioPluginAudioProcessor::getProgramName (int index)
 {
-    juce::ignoreUnused (index);
+    const auto library = getPresetLibrary();
+    if (library != nullptr && juce::isPositiveAndBelow(index, library->size()))
+        return library->getName(index);
     return {};
 }
 
 void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    // The preset library is read-only
     juce::ignoreUnused (index, newName);
 }
 
+bool AudioPluginAudioProcessor::applyPreset (int index)
+{
+    const auto library = getPresetLibrary();
+    if (library == nullptr || !juce::isPositiveAndBelow(index, library->size()))
+        return false;
+
+    // The preset data is a complete plugin state, so applying it is a single state swap straight from the mapped file
+    size_t size = 0;
+    const void* data = library->getStateData(index, size);
+    if (!StateSerializer::read(parameters, data, static_cast<int>(size)))
+        return false;
+    currentProgram = index;
+    return true;
+}
+
 //==============================================================================
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -176,21 +232,140 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 //==============================================================================
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // Save the APVTS state to persist parameter values
-    juce::ValueTree state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml = state.createXml();
-    copyXmlToBinary(*xml, destData);
+    // Save the APVTS state to persist parameter values (compact binary format, see StateSerializer.h)
+    StateSerializer::write(parameters, destData);
 }
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // Load the APVTS state to restore parameter values
-    std::unique_ptr<juce::XmlElement> xmlState = getXmlFromBinary(data, sizeInBytes);
-    if (xmlState != nullptr && xmlState->hasTagName(parameters.state.getType()))
+    // Load the APVTS state to restore parameter values. Also reads states saved as XML by earlier versions.
+    if (!StateSerializer::read(parameters, data, sizeInBytes))
+        DBG("setStateInformation: Could not read the plugin state.");
+}
+
+//==============================================================================
+std::shared_ptr<const PresetLibrary> AudioPluginAudioProcessor::getPresetLibrary()
+{
+    // One mapping for all instances, so constructing an instance doesn't touch the library at all
+    static std::mutex mutex;
+    static std::shared_ptr<const PresetLibrary> library;
+    static bool opened = false;
+
+    std::lock_guard<std::mutex> lock (mutex);
+    if (opened)
+        return library;
+    opened = true;
+
+    // Missing, unreadable (e.g. written in an older format) or built from other sources: rebuild it
+    const auto libraryFile = PresetLibrary::getDefaultFile();
+    const auto stamp = getPresetSourcesStamp();
+    library = PresetLibrary::open (libraryFile);
+    if (library == nullptr || library->getBuildStamp() != stamp)
+    {
+        // Unmapped before the file is replaced
+        library = nullptr;
+        if (buildPresetLibrary (libraryFile, stamp))
+            library = PresetLibrary::open (libraryFile);
+        else
+            DBG ("Could not write the preset library " << libraryFile.getFullPathName());
+    }
+    return library;
+}
+
+// FNV-1a, for the build stamp of the preset library
+static juce::uint64 hashBytes (juce::uint64 hash, const void* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ static_cast<const juce::uint8*> (data)[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+template <typename Value>
+static juce::uint64 hashValue (juce::uint64 hash, Value value)
+{
+    return hashBytes (hash, &value, sizeof (value));
+}
+
+static juce::uint64 hashString (juce::uint64 hash, const juce::String& string)
+{
+    return hashBytes (hash, string.toRawUTF8(), string.getNumBytesAsUTF8());
+}
+
+juce::uint64 AudioPluginAudioProcessor::getPresetSourcesStamp()
+{
+    constexpr juce::uint64 fnvOffsetBasis = 0xcbf29ce484222325ull;
+    // Both formats are in the file
+    auto stamp = hashValue (fnvOffsetBasis, PresetLibrary::currentVersion);
+    stamp = hashValue (stamp, StateSerializer::currentVersion);
+
+    // Factory presets, changed by plugin updates
+    for (int i = 0; i < FactoryPresets::namedResourceListSize; ++i)
+    {
+        int size = 0;
+        const auto* data = FactoryPresets::getNamedResource (FactoryPresets::namedResourceList[i], size);
+        stamp = hashString (stamp, FactoryPresets::getNamedResourceOriginalFilename (FactoryPresets::namedResourceList[i]));
+        stamp = hashBytes (stamp, data, static_cast<size_t> (size));
+    }
+
+    // User presets: path, modification time and size of everything in the folder tree, so added, removed, renamed and
+    // edited files change the stamp at any depth. Summed, as the iteration order is unspecified.
+    const auto userFolder = PresetLibrary::getUserPresetFolder();
+    juce::uint64 userStamp = 0;
+    if (userFolder.isDirectory())
+    {
+        for (const auto& entry : juce::RangedDirectoryIterator (userFolder, true, "*", juce::File::findFilesAndDirectories))
+        {
+            auto entryStamp = hashString (fnvOffsetBasis, entry.getFile().getRelativePathFrom (userFolder));
+            entryStamp = hashValue (entryStamp, entry.getModificationTime().toMilliseconds());
+            entryStamp = hashValue (entryStamp, entry.getFileSize());
+            userStamp += entryStamp;
+        }
+    }
+    return hashValue (stamp, userStamp);
+}
+
+bool AudioPluginAudioProcessor::buildPresetLibrary (const juce::File& file, juce::uint64 buildStamp)
+{
+    PresetLibrary::Builder builder;
+    builder.setBuildStamp (buildStamp);
+    // Preset files are APVTS states as XML, with optional category and tags (comma-separated) attributes on the root
+    auto addPreset = [this, &builder] (const juce::String& name, const juce::String& defaultCategory, juce::XmlElement& xml)
     {
-        juce::ValueTree newState = juce::ValueTree::fromXml(*xmlState);
-        parameters.replaceState(newState);
+        const auto category = xml.getStringAttribute("category", defaultCategory);
+        const auto tags = juce::StringArray::fromTokens(xml.getStringAttribute("tags"), ",", "");
+        xml.removeAttribute("category");
+        xml.removeAttribute("tags");
+        // Stored in the binary format, so applying a preset doesn't go through the XML path
+        juce::MemoryBlock state;
+        if (StateSerializer::writeFromXml(parameters, xml, state))
+            builder.add(name, category, tags, state);
+        else
+            DBG("buildPresetLibrary: " << name << " is not a state of this plugin");
+    };
+
+    for (int i = 0; i < FactoryPresets::namedResourceListSize; ++i)
+    {
+        int size = 0;
+        const auto* data = FactoryPresets::getNamedResource(FactoryPresets::namedResourceList[i], size);
+        if (auto xml = juce::parseXML(juce::String::fromUTF8(data, size)))
+            addPreset(juce::File::createFileWithoutCheckingPath(
+                              FactoryPresets::getNamedResourceOriginalFilename(FactoryPresets::namedResourceList[i]))
+                              .getFileNameWithoutExtension(), "Factory", *xml);
+    }
+
+    // User presets, the subfolder (if any) is the default category
+    const auto userFolder = PresetLibrary::getUserPresetFolder();
+    for (const auto& entry : juce::RangedDirectoryIterator(userFolder, true, "*.xml"))
+    {
+        const auto presetFile = entry.getFile();
+        if (auto xml = juce::parseXML(presetFile))
+        {
+            const auto folder = presetFile.getParentDirectory();
+            addPreset(presetFile.getFileNameWithoutExtension(),
+                      folder == userFolder ? juce::String("User") : folder.getRelativePathFrom(userFolder), *xml);
+        }
     }
+    return builder.writeTo(file);
 }
 
 //==============================================================================
@@ -202,9 +377,111 @@ void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeI
 // It follows that we have to use this particular instance for all our plugin instances and NEVER create a new one
 // Doing so will invalidate the first one and cause a crash.
 ultralight::RefPtr<ultralight::Renderer> AudioPluginAudioProcessor::RENDERER = nullptr;
+ultralight::RefPtr<ultralight::Session> AudioPluginAudioProcessor::SESSION = nullptr;
+AudioPluginAudioProcessor::UltralightStartupTimings AudioPluginAudioProcessor::STARTUP_TIMINGS;
+std::atomic<int> AudioPluginAudioProcessor::NUM_INSTANCES_CREATED { 0 };
 
-// This creates new instances of the plugin
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+const ultralight::RefPtr<ultralight::Renderer>& AudioPluginAudioProcessor::getRenderer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // This makes sure we set up the platform and create ONE renderer per application, and only once it is needed
+    if (RENDERER.get() == nullptr)
+    {
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        setUpUltralightPlatform();
+        auto platformReady = juce::Time::getMillisecondCounterHiRes();
+        RENDERER = Renderer::Create();
+        // One persistent session for all views, so they share Ultralight's caches (decoded images, parsed
+        // stylesheets and scripts, HTTP cache for CDN libraries on disk)
+        SESSION = RENDERER->CreateSession(true, "UltralightJUCE");
+        getRendererMemoryManager().setRenderer(RENDERER);
+
+        STARTUP_TIMINGS.platformSetupMs = platformReady - start;
+        STARTUP_TIMINGS.rendererCreationMs = juce::Time::getMillisecondCounterHiRes() - platformReady;
+        STARTUP_TIMINGS.instancesCreatedBefore = NUM_INSTANCES_CREATED.load();
+        DBG("Ultralight bring-up: platform " << STARTUP_TIMINGS.platformSetupMs << " ms, renderer "
+            << STARTUP_TIMINGS.rendererCreationMs << " ms, " << STARTUP_TIMINGS.instancesCreatedBefore
+            << " plugin instance(s) created before");
+    }
+    return RENDERER;
+}
+
+const ultralight::RefPtr<ultralight::Session>& AudioPluginAudioProcessor::getSession()
+{
+    getRenderer();
+    return SESSION;
+}
+
+SharedResourceCache& AudioPluginAudioProcessor::getSharedResourceCache()
+{
+    // Files on disk, read once per process
+    static SharedResourceCache cache(GetPlatformFileSystem(JS_RESOURCES_PATH.c_str()));
+    return cache;
+}
+
+RendererMemoryManager& AudioPluginAudioProcessor::getRendererMemoryManager()
+{
+    // Shared by all plugin instances, like the renderer
+    static RendererMemoryManager manager;
+    return manager;
+}
+
+// Reads a whole file through an Ultralight FileSystem (empty if it can't be read)
+static juce::String readFile (ultralight::FileSystem& fileSystem, const char* path)
+{
+    auto handle = fileSystem.OpenFile (ultralight::String16 (path), false);
+    if (handle == ultralight::invalidFileHandle)
+        return {};
+    int64_t size = 0;
+    juce::MemoryBlock contents;
+    if (fileSystem.GetFileSize (handle, size) && size > 0)
+    {
+        contents.setSize (static_cast<size_t> (size));
+        int64_t position = 0;
+        while (position < size)
+        {
+            const auto bytesRead = fileSystem.ReadFromFile (handle, static_cast<char*> (contents.getData()) + position, size - position);
+            if (bytesRead <= 0)
+                break;
+            position += bytesRead;
+        }
+        contents.setSize (static_cast<size_t> (position));
+    }
+    fileSystem.CloseFile (handle);
+    return contents.toString();
+}
+
+// Serves the sprite atlas at the device scale (see SpriteAtlas.h): the one pre-rendered at build time if there is
+// one for this scale, otherwise it is rendered now from the SVGs, read through the file system Ultralight uses
+static void provideSpriteAtlas (float scale)
+{
+    ULJ_TRACE_SCOPE ("provideSpriteAtlas");
+    juce::MemoryBlock png;
+#if ULTRALIGHTJUCE_PRERENDER_SPRITES
+    const auto fileName = SpriteAtlas::getFileName (scale);
+    for (int i = 0; i < SpriteResources::namedResourceListSize && png.isEmpty(); ++i)
+    {
+        int size = 0;
+        if (fileName == SpriteResources::originalFilenames[i])
+            if (const char* data = SpriteResources::getNamedResource (SpriteResources::namedResourceList[i], size))
+                png.replaceAll (data, static_cast<size_t> (size));
+    }
+#endif
+    if (png.isEmpty())
+    {
+        auto* fileSystem = Platform::instance().file_system();
+        if (fileSystem == nullptr)
+            return;
+        png = SpriteAtlas::renderPNG (scale, [fileSystem] (const char* path) { return readFile (*fileSystem, path); });
+        DBG ("SpriteAtlas: no pre-rendered atlas for scale " << scale << ", rendered it at runtime");
+    }
+    if (! png.isEmpty())
+        AudioPluginAudioProcessor::getSharedResourceCache().put (SpriteAtlas::ATLAS_URL, std::move (png));
+}
+
+// Called exactly once per process, right before the renderer is created
+void AudioPluginAudioProcessor::setUpUltralightPlatform()
 {
     // ================================== ULTRALIGHT ==================================
     Config config;
@@ -215,23 +492,39 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     // The GPU renderer should be disabled to render Views to a pixel-buffer (Surface).
     config.use_gpu_renderer = false;
     // You can set a custom DPI scale here. Default is 1.0 (100%)
-    auto scale = juce::Desktop::getInstance().getDisplays().displays[0].scale;
+    // There is no display when running headless (e.g. the benchmarks on a CI machine)
+    const auto* display = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay();
+    auto scale = display != nullptr ? display->scale : 1.0;
     config.device_scale = scale;
+    // Where persistent sessions keep their cache (e.g. JS libraries loaded from a CDN)
+    config.cache_path = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("UltralightJUCE").getChildFile("Cache").getFullPathName().toRawUTF8();
 
     // Pass our configuration to the Platform singleton so that the library can use it.
     Platform::instance().set_config(config);
     // Use the OS's native font loader
     Platform::instance().set_font_loader(GetPlatformFontLoader());
-    // Use the OS's native file loader, with a base directory
-    // All file:// URLs will load relative to this base directory.
-    // For shipping, this needs to be tied to JUCE Binary files or a custom resource directory
-    Platform::instance().set_file_system(GetPlatformFileSystem(JS_RESOURCES_PATH.c_str()));
+    // All file:// URLs are resolved by this file system.
+#if ULTRALIGHTJUCE_LOOSE_RESOURCES
+    // Development: use the OS's native file loader, with JS_RESOURCES_PATH as base directory (enables hot-reloading).
+    // Files are cached in memory for all views, hot-reloading invalidates them.
+    Platform::instance().set_file_system(&getSharedResourceCache());
+#else
+    // Shipping: serve the resources compiled into the binary. Files that are not embedded (e.g. the inspector) are
+    // still loaded from JS_RESOURCES_PATH if it exists.
+    static ResourceFileSystem resourceFileSystem(&getSharedResourceCache());
+    Platform::instance().set_file_system(&resourceFileSystem);
+#endif
     // Use the default logger (writes to a log file)
     Platform::instance().set_logger(GetDefaultLogger("ultralight.log"));
 
-    // This makes sure we only have ONE renderer per application
-    if(AudioPluginAudioProcessor::RENDERER.get() == nullptr)
-        AudioPluginAudioProcessor::RENDERER = Renderer::Create();
+    // Pre-rasterized control graphics at the device scale, served from memory (see SpriteAtlas.h)
+    provideSpriteAtlas(static_cast<float>(scale));
+}
 
+// This creates new instances of the plugin
+// Ultralight is brought up lazily by getRenderer() when the first editor opens
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
     return new AudioPluginAudioProcessor();
 }
@@ -9,6 +9,13 @@
 #include "Ultralight/RefPtr.h"
 #include "Ultralight/Renderer.h"
 #include "Config.h"
+#include "ParameterSmoother.h"
+#include "PresetLibrary.h"
+#include "AudioLoadMeter.h"
+#include "HostTransport.h"
+#include "RendererMemoryManager.h"
+
+class SharedResourceCache;
 
 //==============================================================================
 class AudioPluginAudioProcessor  :
@@ -19,7 +26,33 @@ public:
     //==============================================================================
     AudioPluginAudioProcessor();
     ~AudioPluginAudioProcessor() override;
-    static ultralight::RefPtr<ultralight::Renderer> RENDERER;
+
+    /// \brief The Ultralight renderer shared by all plugin instances.
+    /// The Ultralight platform is set up and the renderer is created on the first call (when the first editor opens),
+    /// so instances that never show an editor (offline bounces, hidden tracks) don't pay for it.
+    /// Must only be called on the JUCE Message thread.
+    static const ultralight::RefPtr<ultralight::Renderer>& getRenderer();
+
+    /// \brief The Ultralight session shared by all views (creates the renderer if needed). Message thread only.
+    static const ultralight::RefPtr<ultralight::Session>& getSession();
+
+    /// \brief Contents of the files loaded from disk, shared by all views of the process (see SharedResourceCache.h)
+    static SharedResourceCache& getSharedResourceCache();
+
+    /// \brief Timings of the one-time Ultralight bring-up (all 0 until getRenderer() was called for the first time)
+    struct UltralightStartupTimings {
+        double platformSetupMs = 0.0;
+        double rendererCreationMs = 0.0;
+        // Plugin instances that were created before the renderer was needed (each used to set up the platform)
+        int instancesCreatedBefore = 0;
+    };
+    static UltralightStartupTimings getUltralightStartupTimings() { return STARTUP_TIMINGS; }
+
+    /// \brief Purges the renderer's caches when editors close or idle, and enforces the memory budget
+    /// (see RendererMemoryManager.h). Message thread only.
+    static RendererMemoryManager& getRendererMemoryManager();
+    /// \brief Current memory usage of the shared renderer and the process. Message thread only.
+    static RendererMemoryManager::Usage getRendererMemoryUsage() { return getRendererMemoryManager().getUsage(); }
 
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -55,8 +88,47 @@ public:
 
     juce::AudioProcessorValueTreeState parameters;
 
+    //==============================================================================
+    /// \brief The preset library (see PresetLibrary.h), nullptr if there is none. All instances share one mapping,
+    /// which is opened on first use (and the library built or rebuilt then if it is missing or stale).
+    std::shared_ptr<const PresetLibrary> getPresetLibrary();
+    /// \brief Applies a preset of the library by swapping in its stored state
+    bool applyPreset (int index);
+
+    //==============================================================================
+    /// \brief Real-time load of processBlock (max, percentiles, deadline misses), safe to call from any thread
+    AudioLoadMeter::Stats getAudioLoadStats() const { return loadMeter.getStats(); }
+    void resetAudioLoadStats() { loadMeter.reset(); }
+    /// \brief The host's transport as of the last processBlock call, safe to read from any thread
+    const HostTransport& getHostTransport() const { return hostTransport; }
+
 
 private:
+    // See getRenderer()
+    static ultralight::RefPtr<ultralight::Renderer> RENDERER;
+    static ultralight::RefPtr<ultralight::Session> SESSION;
+    static UltralightStartupTimings STARTUP_TIMINGS;
+    static std::atomic<int> NUM_INSTANCES_CREATED;
+    static void setUpUltralightPlatform();
+
+    /// \brief Packs the factory presets and the user preset folder into a library file
+    bool buildPresetLibrary (const juce::File& file, juce::uint64 buildStamp);
+    /// \brief Identifies what the library is built from (file formats, factory presets, user preset folder)
+    static juce::uint64 getPresetSourcesStamp();
+
+    // Program of the preset library (presets are exposed to the host as programs)
+    int currentProgram = 0;
+
+    // Per-sample smoothing of the parameters used in processBlock
+    ParameterSmoother smoother;
+    int gainSmootherIndex = -1;
+
+    // Measures processBlock against the real-time budget of each block
+    AudioLoadMeter loadMeter;
+
+    // Tempo, position and play state of the host, for the UI (see ParameterMirror.h)
+    HostTransport hostTransport;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
 
@@ -0,0 +1,107 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_PRESETBROWSER_H
+#define ULTRALIGHTJUCE_PRESETBROWSER_H
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "JSStructFields.h"
+#include "PresetLibrary.h"
+
+/// \brief One preset as seen by the web UI
+struct PresetInfo {
+    int index = -1;
+    juce::String name;
+    juce::String category;
+    std::vector<juce::String> tags;
+};
+
+template<>
+struct JSStructFields<PresetInfo> {
+    static constexpr auto fields = std::make_tuple(
+            jsField("index", &PresetInfo::index),
+            jsField("name", &PresetInfo::name),
+            jsField("category", &PresetInfo::category),
+            jsField("tags", &PresetInfo::tags));
+};
+
+/// \brief Browsing state of one editor: runs searches over the PresetLibrary on a background thread and hands out
+/// the results page by page, so the UI never holds more than one page of presets.
+/// All public methods must be called on the JUCE Message thread.
+class PresetBrowser {
+public:
+    explicit PresetBrowser(std::shared_ptr<const PresetLibrary> libraryIn) : library(std::move(libraryIn)) {}
+
+    ~PresetBrowser() {
+        // Let a running search bail out early
+        ++generation;
+        searchPool.removeAllJobs(true, 1000);
+    }
+
+    /// \brief Starts a search in the background. Any search that is still running is superseded.
+    /// \param onFinished Called on the Message thread with the number of results, unless superseded
+    void search(const juce::String& query, const juce::String& category, const juce::String& tag,
+                std::function<void(int)> onFinished) {
+        if (library == nullptr) {
+            onFinished(0);
+            return;
+        }
+        const int searchGeneration = ++generation;
+        juce::WeakReference<PresetBrowser> weakThis(this);
+        auto searchedLibrary = library;
+        searchPool.addJob([this, weakThis, searchedLibrary, query, category, tag, searchGeneration, onFinished] {
+            auto found = std::make_shared<std::vector<juce::uint32>>(
+                    searchedLibrary->search(query, category, tag, &generation, searchGeneration));
+            juce::MessageManager::callAsync([weakThis, found, searchGeneration, onFinished] {
+                if (weakThis == nullptr || weakThis->generation.load() != searchGeneration)
+                    return;
+                weakThis->results = found;
+                onFinished(static_cast<int>(found->size()));
+            });
+        });
+    }
+
+    /// \brief Number of presets in the current result set (all presets if no search ran yet)
+    int getNumResults() const {
+        if (library == nullptr)
+            return 0;
+        return results != nullptr ? static_cast<int>(results->size()) : library->size();
+    }
+
+    /// \brief One page of the current result set
+    std::vector<PresetInfo> getPage(int offset, int count) const {
+        std::vector<PresetInfo> page;
+        const int end = juce::jmin(getNumResults(), offset + count);
+        for (int i = juce::jmax(0, offset); i < end; ++i) {
+            const int index = results != nullptr ? static_cast<int>((*results)[static_cast<size_t>(i)]) : i;
+            auto tags = library->getTags(index);
+            page.push_back({ index, library->getName(index), library->getCategory(index),
+                             std::vector<juce::String>(tags.begin(), tags.end()) });
+        }
+        return page;
+    }
+
+    std::vector<juce::String> getCategories() const {
+        if (library == nullptr)
+            return {};
+        const auto& categories = library->getCategories();
+        return std::vector<juce::String>(categories.begin(), categories.end());
+    }
+
+private:
+    std::shared_ptr<const PresetLibrary> library;
+    // Indices into the library, nullptr means "all presets"
+    std::shared_ptr<const std::vector<juce::uint32>> results;
+    // Incremented for every search, so older searches can detect that they are obsolete
+    std::atomic<int> generation { 0 };
+    juce::ThreadPool searchPool { 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PresetBrowser)
+};
+
+#endif //ULTRALIGHTJUCE_PRESETBROWSER_H
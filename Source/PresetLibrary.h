@@ -0,0 +1,322 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_PRESETLIBRARY_H
+#define ULTRALIGHTJUCE_PRESETLIBRARY_H
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// \brief Read-only preset store that packs any number of presets into a single memory-mapped file.
+///
+/// The file starts with a prebuilt index (name, category and tags of every preset, plus the list of categories),
+/// followed by a string table and the preset states (in the binary format of StateSerializer.h). Opening a library only
+/// maps the file and checks the index bounds, nothing is loaded or parsed up front, so browsing thousands of presets
+/// costs no more memory than the pages that are touched. Use PresetLibrary::Builder to create library files (the plugin
+/// builds its library from the factory presets and the user preset folder and shares one mapping between all
+/// instances, see AudioPluginAudioProcessor::getPresetLibrary()).
+///
+/// The header holds a build stamp chosen by whoever builds the library (e.g. a hash of its sources), so a library
+/// can be checked for staleness without reading the presets.
+///
+/// File layout (little endian, all offsets from the start of the file):
+///   Header, numPresets x IndexEntry, string table (UTF-8, not null-terminated), preset state blobs
+class PresetLibrary {
+public:
+    static constexpr juce::uint32 magic = 0x504a4c55; // "ULJP"
+    static constexpr juce::uint32 currentVersion = 2;
+
+    /// \brief The default location of the library of this plugin
+    static juce::File getDefaultFile() {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                .getChildFile("UltralightJUCE")
+                .getChildFile("Presets.uljpresets");
+    }
+
+    /// \brief The folder users put their own preset files in (APVTS states as XML, one per file). Subfolders are
+    /// categories.
+    static juce::File getUserPresetFolder() {
+        return getDefaultFile().getSiblingFile("Presets");
+    }
+
+    /// \brief Maps a library file. Returns nullptr if the file does not exist or is not a valid library.
+    static std::shared_ptr<const PresetLibrary> open(const juce::File& file) {
+        if (!file.existsAsFile())
+            return nullptr;
+        std::shared_ptr<PresetLibrary> library(new PresetLibrary(file));
+        if (!library->isValid()) {
+            DBG("PresetLibrary: " << file.getFullPathName() << " is not a valid preset library.");
+            return nullptr;
+        }
+        return library;
+    }
+
+    int size() const { return static_cast<int>(header->numPresets); }
+
+    juce::String getName(int index) const { return getString(entry(index).nameOffset, entry(index).nameLength); }
+    juce::String getCategory(int index) const { return getString(entry(index).categoryOffset, entry(index).categoryLength); }
+    juce::StringArray getTags(int index) const {
+        return juce::StringArray::fromTokens(getString(entry(index).tagsOffset, entry(index).tagsLength), ",", "");
+    }
+
+    /// \brief The stored plugin state of a preset (points straight into the mapped file)
+    const void* getStateData(int index, size_t& sizeInBytes) const {
+        sizeInBytes = entry(index).dataSize;
+        return base + entry(index).dataOffset;
+    }
+
+    /// \brief All categories, in the order they first appear (stored in the file, nothing is derived from the index)
+    juce::StringArray getCategories() const {
+        return juce::StringArray::fromLines(getString(header->categoriesOffset, header->categoriesLength));
+    }
+
+    /// \brief The stamp passed to Builder::setBuildStamp() when the library was written
+    juce::uint64 getBuildStamp() const { return header->buildStamp; }
+
+    /// \brief Returns the indices of all presets matching the filters. Empty filters match everything.
+    /// Safe to call from any thread. Allocates only for the result.
+    /// \param query Case-insensitive substring of the name or the tags
+    /// \param category Case-insensitive category name
+    /// \param tag Case-insensitive tag
+    /// \param generation / expectedGeneration The search stops early (and returns what it has) if generation
+    /// changes, i.e. a newer search superseded it
+    std::vector<juce::uint32> search(const juce::String& query, const juce::String& category, const juce::String& tag,
+                                     const std::atomic<int>* generation = nullptr, int expectedGeneration = 0) const {
+        const std::string lowerQuery = query.toLowerCase().toStdString();
+        const std::string lowerCategory = category.toLowerCase().toStdString();
+        const std::string lowerTag = tag.toLowerCase().toStdString();
+
+        std::vector<juce::uint32> results;
+        for (juce::uint32 i = 0; i < header->numPresets; ++i) {
+            if (generation != nullptr && (i & 255) == 0 && generation->load() != expectedGeneration)
+                break;
+            const auto& e = entry(static_cast<int>(i));
+            const char* name = strings + e.nameOffset;
+            const char* tags = strings + e.tagsOffset;
+
+            if (!lowerCategory.empty() && !equalsIgnoreCase(strings + e.categoryOffset, e.categoryLength, lowerCategory))
+                continue;
+            if (!lowerTag.empty() && !containsTag(tags, e.tagsLength, lowerTag))
+                continue;
+            if (!lowerQuery.empty() && !containsIgnoreCase(name, e.nameLength, lowerQuery)
+                && !containsIgnoreCase(tags, e.tagsLength, lowerQuery))
+                continue;
+            results.push_back(i);
+        }
+        return results;
+    }
+
+    // ================================== Builder ==================================
+    /// \brief Packs presets into a library file
+    class Builder {
+    public:
+        /// \brief Adds a preset. Tags must not contain commas.
+        void add(const juce::String& name, const juce::String& category, const juce::StringArray& tags,
+                 const juce::MemoryBlock& state) {
+            presets.push_back({ name, category, tags.joinIntoString(","), state });
+        }
+
+        /// \brief Stored in the header, see getBuildStamp()
+        void setBuildStamp(juce::uint64 stamp) { buildStamp = stamp; }
+
+        /// \brief Adds all presets of an existing library, e.g. to extend it
+        void addAll(const PresetLibrary& library) {
+            for (int i = 0; i < library.size(); ++i) {
+                size_t size = 0;
+                const void* data = library.getStateData(i, size);
+                add(library.getName(i), library.getCategory(i), library.getTags(i), juce::MemoryBlock(data, size));
+            }
+        }
+
+        /// \brief Writes the library. Presets are sorted by category and name, so that is the default browsing order.
+        /// The file is written to a temporary file first and then moved into place.
+        bool writeTo(const juce::File& file) {
+            std::stable_sort(presets.begin(), presets.end(), [](const Preset& a, const Preset& b) {
+                const int categoryOrder = a.category.compareIgnoreCase(b.category);
+                return categoryOrder != 0 ? categoryOrder < 0 : a.name.compareIgnoreCase(b.name) < 0;
+            });
+
+            // String table
+            juce::MemoryOutputStream stringTable;
+            std::vector<IndexEntry> index(presets.size());
+            auto addString = [&stringTable](const juce::String& string, juce::uint32& offset, juce::uint16& length) {
+                offset = static_cast<juce::uint32>(stringTable.getDataSize());
+                length = static_cast<juce::uint16>(juce::jmin<size_t>(string.getNumBytesAsUTF8(), 0xffff));
+                stringTable.write(string.toRawUTF8(), length);
+            };
+            juce::StringArray categories;
+            for (size_t i = 0; i < presets.size(); ++i) {
+                addString(presets[i].name, index[i].nameOffset, index[i].nameLength);
+                addString(presets[i].category, index[i].categoryOffset, index[i].categoryLength);
+                addString(presets[i].tags, index[i].tagsOffset, index[i].tagsLength);
+                categories.addIfNotAlreadyThere(presets[i].category);
+            }
+
+            Header header{};
+            header.magic = magic;
+            header.version = currentVersion;
+            header.numPresets = static_cast<juce::uint32>(presets.size());
+            header.buildStamp = buildStamp;
+            // One category per line
+            const auto categoryList = categories.joinIntoString("\n");
+            header.categoriesOffset = static_cast<juce::uint32>(stringTable.getDataSize());
+            header.categoriesLength = static_cast<juce::uint32>(categoryList.getNumBytesAsUTF8());
+            stringTable.write(categoryList.toRawUTF8(), header.categoriesLength);
+            header.entrySize = sizeof(IndexEntry);
+            header.indexOffset = sizeof(Header);
+            header.stringsOffset = header.indexOffset + sizeof(IndexEntry) * presets.size();
+            header.stringsSize = stringTable.getDataSize();
+            // Keep the preset data 8 byte aligned
+            header.dataOffset = (header.stringsOffset + header.stringsSize + 7) & ~static_cast<juce::uint64>(7);
+
+            juce::uint64 dataOffset = header.dataOffset;
+            for (size_t i = 0; i < presets.size(); ++i) {
+                index[i].dataOffset = dataOffset;
+                index[i].dataSize = static_cast<juce::uint32>(presets[i].state.getSize());
+                dataOffset += presets[i].state.getSize();
+            }
+
+            file.getParentDirectory().createDirectory();
+            juce::TemporaryFile temporaryFile(file);
+            {
+                juce::FileOutputStream stream(temporaryFile.getFile());
+                if (!stream.openedOk())
+                    return false;
+                stream.write(&header, sizeof(Header));
+                stream.write(index.data(), sizeof(IndexEntry) * index.size());
+                stream.write(stringTable.getData(), stringTable.getDataSize());
+                for (auto position = header.stringsOffset + header.stringsSize; position < header.dataOffset; ++position)
+                    stream.writeByte(0);
+                for (const auto& preset : presets)
+                    stream.write(preset.state.getData(), preset.state.getSize());
+                stream.flush();
+                if (stream.getStatus().failed())
+                    return false;
+            }
+            return temporaryFile.overwriteTargetFileWithTemporary();
+        }
+
+    private:
+        struct Preset {
+            juce::String name, category, tags;
+            juce::MemoryBlock state;
+        };
+        std::vector<Preset> presets;
+        juce::uint64 buildStamp = 0;
+    };
+
+private:
+    struct Header {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 numPresets;
+        juce::uint32 entrySize;
+        juce::uint64 indexOffset;
+        juce::uint64 stringsOffset;
+        juce::uint64 stringsSize;
+        juce::uint64 dataOffset;
+        juce::uint64 buildStamp;
+        juce::uint32 categoriesOffset; // Newline-separated list in the string table
+        juce::uint32 categoriesLength;
+    };
+
+    struct IndexEntry {
+        juce::uint64 dataOffset;
+        juce::uint32 dataSize;
+        juce::uint32 nameOffset;      // Offsets into the string table
+        juce::uint32 categoryOffset;
+        juce::uint32 tagsOffset;      // Comma-separated
+        juce::uint16 nameLength;
+        juce::uint16 categoryLength;
+        juce::uint16 tagsLength;
+        juce::uint16 reserved;
+    };
+    static_assert(sizeof(Header) == 64 && sizeof(IndexEntry) == 32, "The on-disk layout must not have padding");
+
+    explicit PresetLibrary(const juce::File& file)
+            : mappedFile(std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly)) {
+        if (mappedFile->getData() == nullptr || mappedFile->getSize() < sizeof(Header))
+            return;
+        base = static_cast<const char*>(mappedFile->getData());
+        header = reinterpret_cast<const Header*>(base);
+        if (header->magic != magic || header->version != currentVersion || header->entrySize != sizeof(IndexEntry))
+            return;
+        const auto fileSize = static_cast<juce::uint64>(mappedFile->getSize());
+        if (header->indexOffset + static_cast<juce::uint64>(header->numPresets) * sizeof(IndexEntry) > fileSize
+            || header->stringsOffset + header->stringsSize > fileSize
+            || static_cast<juce::uint64>(header->categoriesOffset) + header->categoriesLength > header->stringsSize)
+            return;
+        index = reinterpret_cast<const IndexEntry*>(base + header->indexOffset);
+        strings = base + header->stringsOffset;
+
+        // Validate every entry once, so the accessors don't have to
+        for (juce::uint32 i = 0; i < header->numPresets; ++i) {
+            const auto& e = index[i];
+            if (static_cast<juce::uint64>(e.nameOffset) + e.nameLength > header->stringsSize
+                || static_cast<juce::uint64>(e.categoryOffset) + e.categoryLength > header->stringsSize
+                || static_cast<juce::uint64>(e.tagsOffset) + e.tagsLength > header->stringsSize
+                || e.dataOffset + e.dataSize > fileSize)
+                return;
+        }
+        valid = true;
+    }
+
+    bool isValid() const { return valid; }
+
+    const IndexEntry& entry(int i) const {
+        jassert(juce::isPositiveAndBelow(i, size()));
+        return index[i];
+    }
+
+    juce::String getString(juce::uint32 offset, juce::uint32 length) const {
+        return juce::String::fromUTF8(strings + offset, static_cast<int>(length));
+    }
+
+    // ASCII case-insensitive helpers that work directly on the mapped bytes (the needles are already lower case)
+    static bool equalsIgnoreCase(const char* text, size_t length, const std::string& lowerNeedle) {
+        return length == lowerNeedle.size() && containsIgnoreCase(text, length, lowerNeedle);
+    }
+
+    static bool containsIgnoreCase(const char* text, size_t length, const std::string& lowerNeedle) {
+        if (lowerNeedle.size() > length)
+            return false;
+        for (size_t start = 0; start + lowerNeedle.size() <= length; ++start) {
+            size_t i = 0;
+            while (i < lowerNeedle.size() && toLowerASCII(text[start + i]) == lowerNeedle[i])
+                ++i;
+            if (i == lowerNeedle.size())
+                return true;
+        }
+        return false;
+    }
+
+    static bool containsTag(const char* tags, size_t length, const std::string& lowerTag) {
+        size_t start = 0;
+        while (start <= length) {
+            size_t end = start;
+            while (end < length && tags[end] != ',')
+                ++end;
+            if (equalsIgnoreCase(tags + start, end - start, lowerTag))
+                return true;
+            start = end + 1;
+        }
+        return false;
+    }
+
+    static char toLowerASCII(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* base = nullptr;
+    const Header* header = nullptr;
+    const IndexEntry* index = nullptr;
+    const char* strings = nullptr;
+    bool valid = false;
+};
+
+#endif //ULTRALIGHTJUCE_PRESETLIBRARY_H
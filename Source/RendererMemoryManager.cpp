@@ -0,0 +1,48 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#include "RendererMemoryManager.h"
+#include "MemoryAccounting.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+size_t RendererMemoryManager::getProcessResidentBytes()
+{
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (K32GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)))
+        return static_cast<size_t> (counters.WorkingSetSize);
+    return 0;
+#elif JUCE_MAC
+    mach_task_basic_info info {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info (mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t> (&info), &count) == KERN_SUCCESS)
+        return static_cast<size_t> (info.resident_size);
+    return 0;
+#elif JUCE_LINUX
+    // Second field of /proc/self/statm is the resident set size in pages
+    auto fields = juce::StringArray::fromTokens (juce::File ("/proc/self/statm").loadFileAsString(), " ", "");
+    if (fields.size() < 2)
+        return 0;
+    return static_cast<size_t> (fields[1].getLargeIntValue()) * static_cast<size_t> (sysconf (_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+size_t RendererMemoryManager::getJSHeapBytes (ultralight::View& view)
+{
+    MemoryAccounting::Snapshot statistics;
+    ultralight::Ref<ultralight::JSContext> context = view.LockJSContext();
+    if (! MemoryAccounting::getJSHeapStatistics (context.get(), statistics))
+        return 0;
+    return static_cast<size_t> (statistics.jsHeapCapacityBytes + statistics.jsExtraMemoryBytes);
+}
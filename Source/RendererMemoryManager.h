@@ -0,0 +1,178 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_RENDERERMEMORYMANAGER_H
+#define ULTRALIGHTJUCE_RENDERERMEMORYMANAGER_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+#include <algorithm>
+#include <vector>
+
+/// \brief Keeps the memory of the shared Ultralight renderer in check over long sessions.
+///
+/// The renderer lives for the whole process, and its caches (glyphs, images, JS heap) keep growing even after the
+/// views that used them are gone. This class
+/// - purges the renderer's caches when the last editor closes and when the UI has been idle for a while,
+/// - purges when the estimated usage exceeds a configurable budget,
+/// - periodically writes a memory report to the Ultralight log (Renderer::LogMemoryUsage),
+/// - provides the current usage (see getUsage()).
+///
+/// Ultralight doesn't report its own memory usage, so the budget is checked against an estimate from numbers that
+/// belong to the renderer only: the view bitmaps plus the JavaScriptCore heap of the views (if the Ultralight build
+/// exports the statistics, see JSCPrivateAPI). Glyph and image caches are not included, so it is a lower bound. The
+/// process' resident memory is reported as well, but not used: in a DAW it also grows with other plugins.
+///
+/// One instance per process, owned next to the renderer (see AudioPluginAudioProcessor::getRendererMemoryManager()).
+/// All methods must be called on the JUCE Message thread, except getProcessResidentBytes().
+class RendererMemoryManager : private juce::Timer {
+public:
+    struct Settings {
+        // Estimated renderer memory above which caches are purged (0 = no budget)
+        size_t budgetBytes = 256 * 1024 * 1024;
+        // Purge after the UI has seen no input for this long (0 = never purge on idle)
+        double idlePurgeSeconds = 30.0;
+        // Write a memory report to the Ultralight log this often while editors are open (0 = never)
+        double logIntervalSeconds = 300.0;
+        // How often usage, idle time and the log interval are checked
+        int checkIntervalMs = 1000;
+    };
+
+    struct Usage {
+        size_t viewBitmapBytes = 0;     // Pixel buffers of all live views (4 bytes per pixel)
+        size_t jsHeapBytes = 0;         // JavaScriptCore heap capacity and extra memory (0 if unavailable)
+        size_t processResidentBytes = 0;    // Whole process, for information only
+        size_t estimatedRendererBytes = 0;  // viewBitmapBytes + jsHeapBytes, checked against the budget
+        size_t budgetBytes = 0;
+        int numViews = 0;
+        int numOpenEditors = 0;
+        int numPurges = 0;
+    };
+
+    ~RendererMemoryManager() override {
+        stopTimer();
+    }
+
+    /// \brief Called once the renderer exists
+    void setRenderer(ultralight::RefPtr<ultralight::Renderer> rendererIn) {
+        renderer = std::move(rendererIn);
+    }
+
+    void setSettings(const Settings& newSettings) {
+        settings = newSettings;
+        if (isTimerRunning())
+            startTimer(settings.checkIntervalMs);
+    }
+
+    const Settings& getSettings() const { return settings; }
+
+    // ================================== Editors and views ==================================
+    void editorOpened() {
+        if (numOpenEditors++ == 0) {
+            lastActivity = lastLog = juce::Time::getMillisecondCounterHiRes();
+            startTimer(settings.checkIntervalMs);
+        }
+    }
+
+    /// \brief Purges the caches when the last editor closed. The purge runs asynchronously, after the editor's views
+    /// have actually been released.
+    void editorClosed() {
+        jassert(numOpenEditors > 0);
+        if (--numOpenEditors > 0)
+            return;
+        stopTimer();
+        juce::MessageManager::callAsync([this] {
+            if (numOpenEditors == 0)
+                purge("last editor closed");
+        });
+    }
+
+    void addView(ultralight::View* view) { views.push_back(view); }
+    void removeView(ultralight::View* view) { views.erase(std::remove(views.begin(), views.end(), view), views.end()); }
+
+    /// \brief Call on user input, resets the idle time
+    void notifyActivity() {
+        lastActivity = juce::Time::getMillisecondCounterHiRes();
+        purgedSinceLastActivity = false;
+    }
+
+    // ================================== Usage ==================================
+    Usage getUsage() const {
+        Usage usage;
+        for (auto* view : views) {
+            usage.viewBitmapBytes += static_cast<size_t>(view->width()) * view->height() * 4;
+            // The views of a renderer may share one JS heap, so take the largest instead of adding them up
+            usage.jsHeapBytes = std::max(usage.jsHeapBytes, getJSHeapBytes(*view));
+        }
+        usage.processResidentBytes = getProcessResidentBytes();
+        usage.estimatedRendererBytes = usage.viewBitmapBytes + usage.jsHeapBytes;
+        usage.budgetBytes = settings.budgetBytes;
+        usage.numViews = static_cast<int>(views.size());
+        usage.numOpenEditors = numOpenEditors;
+        usage.numPurges = numPurges;
+        return usage;
+    }
+
+    /// \brief Releases as much of the renderer's cached memory as possible
+    void purge(const char* reason) {
+        if (renderer.get() == nullptr)
+            return;
+        DBG("RendererMemoryManager: purging (" << reason << ")");
+        renderer->PurgeMemory();
+        ++numPurges;
+    }
+
+    /// \brief Resident memory of the whole process in bytes (0 if unknown). Safe to call from any thread.
+    /// Implemented per platform in RendererMemoryManager.cpp.
+    static size_t getProcessResidentBytes();
+
+    /// \brief JavaScriptCore heap capacity plus memory held outside of it (e.g. by ArrayBuffers) of a view's page, 0
+    /// if the Ultralight build doesn't export the statistics. Implemented in RendererMemoryManager.cpp.
+    static size_t getJSHeapBytes(ultralight::View& view);
+
+private:
+    void timerCallback() override {
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+
+        // Purging can't go below what is in use, so only purge again once the usage grew past the last purge's result.
+        // Back within budget (e.g. views closed), the next overrun purges whatever its size.
+        const auto estimate = getUsage().estimatedRendererBytes;
+        if (settings.budgetBytes > 0 && estimate > settings.budgetBytes) {
+            if (estimate > usageAfterOverBudgetPurge) {
+                purge("over budget");
+                usageAfterOverBudgetPurge = getUsage().estimatedRendererBytes;
+            }
+        } else {
+            usageAfterOverBudgetPurge = 0;
+        }
+
+        if (settings.idlePurgeSeconds > 0.0 && !purgedSinceLastActivity
+            && now - lastActivity > settings.idlePurgeSeconds * 1000.0) {
+            purge("idle");
+            purgedSinceLastActivity = true;
+        }
+
+        if (settings.logIntervalSeconds > 0.0 && now - lastLog > settings.logIntervalSeconds * 1000.0) {
+            lastLog = now;
+            if (renderer.get() != nullptr)
+                renderer->LogMemoryUsage();
+            auto usage = getUsage();
+            DBG("RendererMemoryManager: " << usage.numViews << " views, bitmaps " << (usage.viewBitmapBytes >> 10)
+                << " KB, JS heap " << (usage.jsHeapBytes >> 20) << " MB, estimated " << (usage.estimatedRendererBytes >> 20) << " MB of "
+                << (usage.budgetBytes >> 20) << " MB budget, process " << (usage.processResidentBytes >> 20) << " MB");
+        }
+    }
+
+    ultralight::RefPtr<ultralight::Renderer> renderer;
+    Settings settings;
+    std::vector<ultralight::View*> views;
+    size_t usageAfterOverBudgetPurge = 0;
+    int numOpenEditors = 0;
+    int numPurges = 0;
+    double lastActivity = 0.0;
+    double lastLog = 0.0;
+    bool purgedSinceLastActivity = false;
+};
+
+#endif //ULTRALIGHTJUCE_RENDERERMEMORYMANAGER_H
@@ -0,0 +1,179 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_RESOURCEFILESYSTEM_H
+#define ULTRALIGHTJUCE_RESOURCEFILESYSTEM_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FileSystem.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include "FileHandleTable.h"
+
+// Generated by juce_add_binary_data() from the Resources folder (see CMakeLists.txt)
+#include <WebResources.h>
+// Generated by CMake alongside it: the resources' paths relative to the Resources folder
+#include <WebResourcePaths.h>
+
+/// \brief Ultralight FileSystem that serves the web UI (HTML, JS, CSS, images, ...) from the resources compiled into
+/// the binary, so shipping builds don't depend on loose files on disk.
+///
+/// All resources are indexed once in a hash map by their path relative to the Resources folder (e.g. "img/knob.svg"),
+/// lookups afterwards are a single hash. Reads copy straight from the embedded data into Ultralight's buffer, nothing
+/// is loaded or copied on open.
+///
+/// JUCE's BinaryData only keeps the file name of each resource, so CMake writes the relative paths into
+/// WebResourcePaths.h. A request only matches the resource at exactly that path, files of the same name elsewhere
+/// (e.g. in the inspector's tree) still go to the fallback.
+///
+/// Paths that are not embedded (e.g. the inspector, which is not compiled in) are passed on to the fallback
+/// FileSystem, if one is given. Both kinds of open files share one handle table (see FileHandleTable).
+class ResourceFileSystem : public ultralight::FileSystem {
+public:
+    explicit ResourceFileSystem(ultralight::FileSystem* fallbackIn = nullptr) : fallback(fallbackIn) {
+        static_assert(sizeof(WebResources::relativePaths) / sizeof(WebResources::relativePaths[0])
+                      == static_cast<size_t>(WebResources::namedResourceListSize),
+                      "WebResourcePaths.h is out of sync with WebResources.h");
+        for (int i = 0; i < WebResources::namedResourceListSize; ++i) {
+            const std::string relativePath = WebResources::relativePaths[i];
+            // Both lists are in the order the files were passed to juce_add_binary_data()
+            jassert(juce::File::createFileWithoutCheckingPath(relativePath).getFileName()
+                    == WebResources::originalFilenames[i]);
+            int size = 0;
+            const char* data = WebResources::getNamedResource(WebResources::namedResourceList[i], size);
+            if (data != nullptr)
+                resources[relativePath] = { data, static_cast<int64_t>(size) };
+        }
+    }
+
+    bool FileExists(const ultralight::String16& path) override {
+        if (find(path) != nullptr)
+            return true;
+        return fallback != nullptr && fallback->FileExists(path);
+    }
+
+    bool GetFileSize(ultralight::FileHandle handle, int64_t& result) override {
+        ultralight::FileHandle fallbackHandle;
+        if (openFiles.getInnerHandle(handle, fallbackHandle))
+            return fallback->GetFileSize(fallbackHandle, result);
+        return openFiles.withOwnFile(handle, false, [&result](OpenResource& file) {
+            result = file.resource->size;
+            return true;
+        });
+    }
+
+    bool GetFileMimeType(const ultralight::String16& path, ultralight::String16& result) override {
+        if (find(path) == nullptr && fallback != nullptr)
+            return fallback->GetFileMimeType(path, result);
+        result = ultralight::String16(getMimeType(normalise(path)));
+        return true;
+    }
+
+    ultralight::FileHandle OpenFile(const ultralight::String16& path, bool openForWriting) override {
+        const Resource* resource = openForWriting ? nullptr : find(path);
+        if (resource == nullptr) {
+            if (fallback == nullptr)
+                return ultralight::invalidFileHandle;
+            return openFiles.addInner(fallback->OpenFile(path, openForWriting));
+        }
+        return openFiles.addOwn({ resource, 0 });
+    }
+
+    void CloseFile(ultralight::FileHandle& handle) override {
+        auto fallbackHandle = openFiles.remove(handle);
+        if (fallbackHandle != ultralight::invalidFileHandle)
+            fallback->CloseFile(fallbackHandle);
+        handle = ultralight::invalidFileHandle;
+    }
+
+    int64_t ReadFromFile(ultralight::FileHandle handle, char* data, int64_t length) override {
+        ultralight::FileHandle fallbackHandle;
+        if (openFiles.getInnerHandle(handle, fallbackHandle))
+            return fallback->ReadFromFile(fallbackHandle, data, length);
+        return openFiles.withOwnFile(handle, static_cast<int64_t>(-1), [data, length](OpenResource& file) {
+            const auto bytesRead = juce::jmin(length, file.resource->size - file.position);
+            std::memcpy(data, file.resource->data + file.position, static_cast<size_t>(bytesRead));
+            file.position += bytesRead;
+            return bytesRead;
+        });
+    }
+
+    /// \brief MIME type by file extension, for everything a web UI typically ships
+    static const char* getMimeType(const std::string& path) {
+        static const std::unordered_map<std::string, const char*> mimeTypes {
+                { "html", "text/html" },          { "htm", "text/html" },
+                { "js", "text/javascript" },      { "mjs", "text/javascript" },
+                { "css", "text/css" },            { "json", "application/json" },
+                { "txt", "text/plain" },          { "xml", "application/xml" },
+                { "svg", "image/svg+xml" },       { "png", "image/png" },
+                { "jpg", "image/jpeg" },          { "jpeg", "image/jpeg" },
+                { "gif", "image/gif" },           { "webp", "image/webp" },
+                { "ico", "image/x-icon" },        { "woff", "font/woff" },
+                { "woff2", "font/woff2" },        { "ttf", "font/ttf" },
+                { "otf", "font/otf" },            { "wasm", "application/wasm" }
+        };
+        const auto dot = path.find_last_of('.');
+        if (dot != std::string::npos) {
+            std::string extension = path.substr(dot + 1);
+            for (auto& c : extension)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            auto it = mimeTypes.find(extension);
+            if (it != mimeTypes.end())
+                return it->second;
+        }
+        return "application/octet-stream";
+    }
+
+private:
+    struct Resource {
+        const char* data = nullptr;
+        int64_t size = 0;
+    };
+
+    struct OpenResource {
+        const Resource* resource = nullptr;
+        int64_t position = 0;
+    };
+
+    /// \brief Converts an Ultralight path to the relative path used as key: UTF-8, forward slashes, without
+    /// "file://", leading slashes or "./", query and fragment
+    static std::string normalise(const ultralight::String16& path) {
+        auto* start = reinterpret_cast<const juce::CharPointer_UTF16::CharType*>(path.data());
+        std::string result = juce::String(juce::CharPointer_UTF16(start), juce::CharPointer_UTF16(start + path.length()))
+                .toStdString();
+        const auto queryOrFragment = result.find_first_of("?#");
+        if (queryOrFragment != std::string::npos)
+            result.erase(queryOrFragment);
+        std::replace(result.begin(), result.end(), '\\', '/');
+        if (result.compare(0, 7, "file://") == 0)
+            result.erase(0, 7);
+        size_t relativeStart = 0;
+        while (true) {
+            if (result.compare(relativeStart, 1, "/") == 0)
+                relativeStart += 1;
+            else if (result.compare(relativeStart, 2, "./") == 0)
+                relativeStart += 2;
+            else
+                break;
+        }
+        result.erase(0, relativeStart);
+        return result;
+    }
+
+    const Resource* find(const ultralight::String16& path) const {
+        auto it = resources.find(normalise(path));
+        return it != resources.end() ? &it->second : nullptr;
+    }
+
+    ultralight::FileSystem* fallback;
+    // Built once in the constructor, read-only afterwards (so lookups from Ultralight's threads need no lock)
+    std::unordered_map<std::string, Resource> resources;
+    // Our open resources and the fallback's open files
+    FileHandleTable<OpenResource> openFiles;
+};
+
+#endif //ULTRALIGHTJUCE_RESOURCEFILESYSTEM_H
@@ -0,0 +1,205 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_SHAREDRESOURCECACHE_H
+#define ULTRALIGHTJUCE_SHAREDRESOURCECACHE_H
+
+#include <JuceHeader.h>
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FileSystem.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "FileHandleTable.h"
+
+/// \brief Ultralight FileSystem that keeps the contents of every file it served in memory, for all views of the
+/// process. The first editor reads index.html, script.js, images etc. from the wrapped FileSystem (usually the disk),
+/// every further editor gets them from memory.
+///
+/// Decoded images and parsed stylesheets/scripts are cached by Ultralight itself (per renderer and session), so they
+/// are shared as long as all views use the same Session, see AudioPluginAudioProcessor::getSession().
+///
+/// Call invalidate() when a file changes on disk (hot-reloading), so the next load reads it again.
+/// All methods are thread-safe, Ultralight calls them from its own threads.
+class SharedResourceCache : public ultralight::FileSystem {
+public:
+    struct Stats {
+        int64_t hits = 0;
+        int64_t misses = 0;
+        int64_t cachedBytes = 0;
+        int numFiles = 0;
+    };
+
+    /// \param source The FileSystem to read from on a cache miss. Not owned, must outlive this cache.
+    /// \param maxFileSizeIn Files larger than this are never cached (but still served)
+    explicit SharedResourceCache(ultralight::FileSystem* sourceIn, int64_t maxFileSizeIn = 16 * 1024 * 1024)
+            : source(sourceIn), maxFileSize(maxFileSizeIn) {}
+
+    bool FileExists(const ultralight::String16& path) override {
+        if (lookup(path) != nullptr)
+            return true;
+        return source->FileExists(path);
+    }
+
+    bool GetFileSize(ultralight::FileHandle handle, int64_t& result) override {
+        ultralight::FileHandle sourceHandle;
+        if (openFiles.getInnerHandle(handle, sourceHandle))
+            return source->GetFileSize(sourceHandle, result);
+        return openFiles.withOwnFile(handle, false, [&result](OpenResource& file) {
+            result = static_cast<int64_t>(file.contents->getSize());
+            return true;
+        });
+    }
+
+    bool GetFileMimeType(const ultralight::String16& path, ultralight::String16& result) override {
+        return source->GetFileMimeType(path, result);
+    }
+
+    ultralight::FileHandle OpenFile(const ultralight::String16& path, bool openForWriting) override {
+        if (openForWriting) {
+            invalidate(toJuceString(path));
+            return openFiles.addInner(source->OpenFile(path, true));
+        }
+
+        auto contents = lookup(path);
+        if (contents != nullptr) {
+            ++hits;
+        } else {
+            ++misses;
+            contents = load(path);
+            if (contents == nullptr) {
+                // Missing or too large to cache, serve it straight from the source
+                return openFiles.addInner(source->OpenFile(path, false));
+            }
+        }
+        return openFiles.addOwn({ contents, 0 });
+    }
+
+    void CloseFile(ultralight::FileHandle& handle) override {
+        auto sourceHandle = openFiles.remove(handle);
+        if (sourceHandle != ultralight::invalidFileHandle)
+            source->CloseFile(sourceHandle);
+        handle = ultralight::invalidFileHandle;
+    }
+
+    int64_t ReadFromFile(ultralight::FileHandle handle, char* data, int64_t length) override {
+        ultralight::FileHandle sourceHandle;
+        if (openFiles.getInnerHandle(handle, sourceHandle))
+            return source->ReadFromFile(sourceHandle, data, length);
+        return openFiles.withOwnFile(handle, static_cast<int64_t>(-1), [data, length](OpenResource& file) {
+            const auto size = static_cast<int64_t>(file.contents->getSize());
+            const auto bytesRead = juce::jmin(length, size - file.position);
+            std::memcpy(data, static_cast<const char*>(file.contents->getData()) + file.position, static_cast<size_t>(bytesRead));
+            file.position += bytesRead;
+            return bytesRead;
+        });
+    }
+
+    // ================================== Cache control ==================================
+    /// \brief Drops a file from the cache. Views that have it open keep reading the old contents.
+    /// \param path Relative path as Ultralight requests it, an absolute path on disk (e.g. from the FileWatcher) or
+    /// only a file name (matches the file in every directory)
+    void invalidate(const juce::String& path) {
+        const auto changed = path.replaceCharacter('\\', '/');
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = files.begin(); it != files.end();) {
+            const juce::String key(it->first);
+            if (key == changed || key.endsWith("/" + changed) || changed.endsWith("/" + key))
+                it = files.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    /// \brief Serves contents that don't exist in the source (e.g. generated at runtime, like the sprite atlas) under a
+    /// path. Kept until the path is invalidated or the cache is cleared.
+    void put(const juce::String& path, juce::MemoryBlock contents) {
+        std::lock_guard<std::mutex> lock(mutex);
+        files[path.replaceCharacter('\\', '/').toStdString()] = std::make_shared<const juce::MemoryBlock>(std::move(contents));
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        files.clear();
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.hits = hits.load();
+        stats.misses = misses.load();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& file : files)
+            stats.cachedBytes += static_cast<int64_t>(file.second->getSize());
+        stats.numFiles = static_cast<int>(files.size());
+        return stats;
+    }
+
+private:
+    using Contents = std::shared_ptr<const juce::MemoryBlock>;
+
+    struct OpenResource {
+        Contents contents;
+        int64_t position = 0;
+    };
+
+    static juce::String toJuceString(const ultralight::String16& path) {
+        auto* start = reinterpret_cast<const juce::CharPointer_UTF16::CharType*>(path.data());
+        return juce::String(juce::CharPointer_UTF16(start), juce::CharPointer_UTF16(start + path.length()));
+    }
+
+    /// \brief Cache key: the path without query and fragment, with forward slashes
+    static std::string getKey(const ultralight::String16& path) {
+        auto key = toJuceString(path).upToFirstOccurrenceOf("?", false, false)
+                                     .upToFirstOccurrenceOf("#", false, false)
+                                     .replaceCharacter('\\', '/');
+        return key.toStdString();
+    }
+
+    Contents lookup(const ultralight::String16& path) const {
+        const auto key = getKey(path);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = files.find(key);
+        return it != files.end() ? it->second : nullptr;
+    }
+
+    /// \brief Reads the whole file from the source and caches it (without holding the lock while reading)
+    Contents load(const ultralight::String16& path) {
+        auto handle = source->OpenFile(path, false);
+        if (handle == ultralight::invalidFileHandle)
+            return nullptr;
+        int64_t size = 0;
+        if (!source->GetFileSize(handle, size) || size < 0 || size > maxFileSize) {
+            source->CloseFile(handle);
+            return nullptr;
+        }
+        auto contents = std::make_shared<juce::MemoryBlock>(static_cast<size_t>(size));
+        int64_t position = 0;
+        while (position < size) {
+            const auto bytesRead = source->ReadFromFile(handle, static_cast<char*>(contents->getData()) + position, size - position);
+            if (bytesRead <= 0)
+                break;
+            position += bytesRead;
+        }
+        source->CloseFile(handle);
+        if (position != size)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // Another view may have loaded it in the meantime, keep the first one
+        return files.emplace(getKey(path), std::move(contents)).first->second;
+    }
+
+    ultralight::FileSystem* source;
+    const int64_t maxFileSize;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Contents> files;
+    // Cached files being read and files opened straight from the source (see FileHandleTable)
+    FileHandleTable<OpenResource> openFiles;
+    std::atomic<int64_t> hits { 0 }, misses { 0 };
+};
+
+#endif //ULTRALIGHTJUCE_SHAREDRESOURCECACHE_H
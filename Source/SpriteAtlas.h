@@ -0,0 +1,158 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_SPRITEATLAS_H
+#define ULTRALIGHTJUCE_SPRITEATLAS_H
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+/// \brief Pre-rasterizes the SVGs of rotary controls into one PNG atlas, so the page draws them as bitmap blits
+/// (a background-position change) instead of rasterizing the vector graphic in every frame of a drag.
+///
+/// Every sprite is a grid of numFrames frames of frameSize x frameSize CSS pixels, frame i showing the SVG rotated by
+/// minAngle + (maxAngle - minAngle) * i / (numFrames - 1) degrees. The sprites are stacked vertically in the atlas.
+/// The atlas is rendered at the device scale, and shown with a CSS background-size of its size in CSS pixels, so
+/// every frame maps 1:1 onto device pixels.
+///
+/// Atlases for the usual scales are pre-rendered at build time by the SpriteAtlasBuilder tool (see Tools/) and
+/// embedded; other scales are rendered when the renderer is created (see AudioPluginAudioProcessor). Either way the
+/// page loads it from ATLAS_URL and finds the layout in window.SpriteAtlas (see getManifestScript()).
+///
+/// The atlas is decoded into numFrames * (frameSize * scale)^2 * 4 bytes per sprite, so numFrames trades angular
+/// resolution against memory. Only depends on juce_gui_basics, so the build tool can use it without the plugin.
+class SpriteAtlas {
+public:
+    struct Sprite {
+        const char* name;           // Key in window.SpriteAtlas.sprites
+        const char* svgPath;        // Relative to the Resources folder
+        int numFrames;
+        int frameSize;              // CSS pixels
+        float minAngle;             // Degrees, clockwise
+        float maxAngle;
+    };
+
+    /// \brief Where the page loads the atlas from (served from memory, see SharedResourceCache::put())
+    static constexpr const char* ATLAS_URL = "sprites/atlas.png";
+
+    /// \brief The sprites in the atlas. Changing them changes the pre-rendered atlases with the next build.
+    static const std::vector<Sprite>& getSprites() {
+        static const std::vector<Sprite> sprites {
+                // The gain knob in Resources/index.html, the rotation matches gainUpdate() in Resources/script.js
+                { "gainKnob", "img/gainKnob.svg", 64, 100, -145.0f, 145.0f }
+        };
+        return sprites;
+    }
+
+    /// \brief File name of the pre-rendered atlas for a device scale, e.g. "sprites@1.5x.png" (must match the names
+    /// in CMakeLists.txt)
+    static juce::String getFileName(float scale) {
+        auto text = juce::String(juce::roundToInt(scale * 100.0f) / 100.0, 2)
+                .trimCharactersAtEnd("0").trimCharactersAtEnd(".");
+        return "sprites@" + text + "x.png";
+    }
+
+    /// \brief Renders the atlas at a device scale and encodes it as PNG. Message thread (Drawables are Components).
+    /// \param loadSVG Returns the contents of a Sprite::svgPath, or an empty string if it can't be read
+    /// \return An empty block if a SVG couldn't be loaded or parsed
+    static juce::MemoryBlock renderPNG(float scale, const std::function<juce::String(const char*)>& loadSVG) {
+        const auto size = getAtlasSize();
+        juce::Image atlas(juce::Image::ARGB, juce::roundToInt(static_cast<float>(size.x) * scale),
+                          juce::roundToInt(static_cast<float>(size.y) * scale), true);
+        {
+            juce::Graphics g(atlas);
+            int spriteY = 0;
+            for (const auto& sprite : getSprites()) {
+                auto svg = juce::XmlDocument::parse(loadSVG(sprite.svgPath));
+                std::unique_ptr<juce::Drawable> drawable = svg != nullptr ? juce::Drawable::createFromSVG(*svg) : nullptr;
+                if (drawable == nullptr) {
+                    DBG("SpriteAtlas: can't load " << sprite.svgPath);
+                    return {};
+                }
+                const int columns = getColumns(sprite);
+                const float frameSize = static_cast<float>(sprite.frameSize) * scale;
+                for (int i = 0; i < sprite.numFrames; ++i) {
+                    const juce::Rectangle<float> area(static_cast<float>(i % columns) * frameSize,
+                                                      static_cast<float>(spriteY) * scale + static_cast<float>(i / columns) * frameSize,
+                                                      frameSize, frameSize);
+                    const float position = sprite.numFrames > 1 ? static_cast<float>(i) / static_cast<float>(sprite.numFrames - 1) : 0.0f;
+                    const float angle = sprite.minAngle + (sprite.maxAngle - sprite.minAngle) * position;
+                    juce::Graphics::ScopedSaveState state(g);
+                    g.reduceClipRegion(area.getSmallestIntegerContainer());
+                    g.addTransform(juce::AffineTransform::rotation(juce::degreesToRadians(angle), area.getCentreX(), area.getCentreY()));
+                    drawable->drawWithin(g, area, juce::RectanglePlacement::centred, 1.0f);
+                }
+                spriteY += getRows(sprite) * sprite.frameSize;
+            }
+        }
+
+        juce::MemoryBlock png;
+        juce::MemoryOutputStream stream(png, false);
+        juce::PNGImageFormat().writeImageToStream(atlas, stream);
+        stream.flush();
+        return png;
+    }
+
+    /// \brief JS that defines window.SpriteAtlas with the layout of the atlas (in CSS pixels) and
+    /// SpriteAtlas.setFrame(element, name, value), which shows the frame for a value in [0, 1] as the element's
+    /// background. Run it before the page's scripts (from OnWindowObjectReady).
+    static juce::String getManifestScript() {
+        const auto size = getAtlasSize();
+        auto* sprites = new juce::DynamicObject();
+        int spriteY = 0;
+        for (const auto& sprite : getSprites()) {
+            auto* layout = new juce::DynamicObject();
+            layout->setProperty("y", spriteY);
+            layout->setProperty("columns", getColumns(sprite));
+            layout->setProperty("frames", sprite.numFrames);
+            layout->setProperty("size", sprite.frameSize);
+            sprites->setProperty(sprite.name, juce::var(layout));
+            spriteY += getRows(sprite) * sprite.frameSize;
+        }
+        auto* manifest = new juce::DynamicObject();
+        manifest->setProperty("url", ATLAS_URL);
+        manifest->setProperty("width", size.x);
+        manifest->setProperty("height", size.y);
+        manifest->setProperty("sprites", juce::var(sprites));
+
+        return "window.SpriteAtlas = " + juce::JSON::toString(juce::var(manifest), true) + ";\n" + R"JS(
+SpriteAtlas.setFrame = function(element, name, value) {
+    const sprite = SpriteAtlas.sprites[name];
+    if (!element.spriteAtlasReady) {
+        element.style.backgroundImage = 'url(' + SpriteAtlas.url + ')';
+        element.style.backgroundSize = SpriteAtlas.width + 'px ' + SpriteAtlas.height + 'px';
+        element.style.backgroundRepeat = 'no-repeat';
+        element.spriteAtlasReady = true;
+    }
+    const frame = Math.round(Math.min(Math.max(value, 0), 1) * (sprite.frames - 1));
+    const x = (frame % sprite.columns) * sprite.size;
+    const y = sprite.y + Math.floor(frame / sprite.columns) * sprite.size;
+    element.style.backgroundPosition = -x + 'px ' + -y + 'px';
+};)JS";
+    }
+
+private:
+    // Frames are laid out in a square-ish grid, a single row or column could exceed texture size limits
+    static int getColumns(const Sprite& sprite) {
+        return juce::jmax(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(sprite.numFrames)))));
+    }
+
+    static int getRows(const Sprite& sprite) {
+        return (sprite.numFrames + getColumns(sprite) - 1) / getColumns(sprite);
+    }
+
+    /// \brief Size of the atlas in CSS pixels
+    static juce::Point<int> getAtlasSize() {
+        juce::Point<int> size;
+        for (const auto& sprite : getSprites()) {
+            size.x = juce::jmax(size.x, getColumns(sprite) * sprite.frameSize);
+            size.y += getRows(sprite) * sprite.frameSize;
+        }
+        return size;
+    }
+};
+
+#endif //ULTRALIGHTJUCE_SPRITEATLAS_H
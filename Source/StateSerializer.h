@@ -0,0 +1,211 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_STATESERIALIZER_H
+#define ULTRALIGHTJUCE_STATESERIALIZER_H
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/// \brief Compact, versioned binary format for the plugin state (used by get/setStateInformation).
+///
+/// Saving and restoring through ValueTree -> XML -> copyXmlToBinary is slow for large states, and replaceState()
+/// rebuilds the whole tree and notifies every parameter. This format instead stores the normalised parameter values
+/// directly and writes them straight into the parameters on load (only the ones that actually changed).
+/// Any non-parameter state stored in the APVTS tree (e.g. UI state) is kept as a binary ValueTree.
+///
+/// Layout (little endian):
+///   uint32 magic ("ULJS"), uint32 version, uint32 numParameters,
+///   numParameters x { uint16 idLength, idLength bytes UTF-8 id, float32 normalised value },
+///   uint32 extraStateSize, extraStateSize bytes ValueTree::writeToStream() data
+///
+/// Legacy blobs written with copyXmlToBinary() are still read, see read().
+class StateSerializer {
+public:
+    static constexpr juce::uint32 magic = 0x534a4c55; // "ULJS"
+    static constexpr juce::uint32 currentVersion = 1;
+
+    /// \brief Writes the APVTS state in the binary format
+    static void write(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData) {
+        writeBinary(apvts, [](juce::AudioProcessorParameter& parameter) { return parameter.getValue(); },
+                    getNonParameterState(apvts.state), destData);
+    }
+
+    /// \brief Converts a state in the legacy XML layout (the APVTS tree as XML, e.g. a preset file) into the binary
+    /// format, without touching the current state. Parameters missing from the XML get their default value.
+    /// \return false if the XML is not a state of this APVTS
+    static bool writeFromXml(juce::AudioProcessorValueTreeState& apvts, const juce::XmlElement& xml,
+                             juce::MemoryBlock& destData) {
+        if (!xml.hasTagName(apvts.state.getType().toString()))
+            return false;
+        const auto tree = juce::ValueTree::fromXml(xml);
+        writeBinary(apvts, [&tree](juce::AudioProcessorParameter& parameter) {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(&parameter);
+            if (ranged == nullptr)
+                return parameter.getDefaultValue();
+            // Same layout as the APVTS writes: <PARAM id="..." value="..."/> with the unnormalised value
+            const auto node = tree.getChildWithProperty("id", ranged->paramID);
+            if (!isParameterNode(node) || !node.hasProperty("value"))
+                return parameter.getDefaultValue();
+            return ranged->convertTo0to1(static_cast<float>(node.getProperty("value")));
+        }, getNonParameterState(tree), destData);
+        return true;
+    }
+
+    /// \brief True if the data starts with the header of the binary format
+    static bool isBinaryState(const void* data, int sizeInBytes) {
+        return sizeInBytes >= 8 && juce::ByteOrder::littleEndianInt(data) == magic;
+    }
+
+    /// \brief Restores the state from either the binary format or a legacy copyXmlToBinary() blob
+    /// \return false if the data could not be read
+    static bool read(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes) {
+        if (isBinaryState(data, sizeInBytes))
+            return readBinary(apvts, data, sizeInBytes);
+        return readLegacyXml(apvts, data, sizeInBytes);
+    }
+
+    /// \brief Restores the state from the binary format, writing the values directly into the parameters. The whole
+    /// blob is validated first: if it is truncated or corrupt, false is returned and nothing is changed.
+    static bool readBinary(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes) {
+        juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+        if (static_cast<juce::uint32>(stream.readInt()) != magic)
+            return false;
+        const auto version = static_cast<juce::uint32>(stream.readInt());
+        if (version == 0 || version > currentVersion) {
+            DBG("StateSerializer: Unsupported state version " << (int) version);
+            return false;
+        }
+
+        const auto& parameters = apvts.processor.getParameters();
+        if (stream.getNumBytesRemaining() < 4)
+            return false;
+        const int numParameters = stream.readInt();
+        // Every entry takes at least 6 bytes (an empty ID and the value)
+        if (numParameters < 0 || numParameters > stream.getNumBytesRemaining() / 6)
+            return false;
+
+        // Parsed completely before anything is applied
+        std::vector<std::pair<juce::RangedAudioParameter*, float>> values;
+        values.reserve(static_cast<size_t>(juce::jmin(numParameters, parameters.size())));
+        for (int i = 0; i < numParameters; ++i) {
+            if (stream.getNumBytesRemaining() < 2)
+                return false;
+            const auto idLength = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+            if (stream.getNumBytesRemaining() < idLength + 4)
+                return false;
+            // The ID is used in place, the stream reads from the caller's data
+            const char* id = static_cast<const char*>(data) + stream.getPosition();
+            stream.skipNextBytes(idLength);
+            const float value = stream.readFloat();
+            if (!std::isfinite(value))
+                return false;
+
+            // Fast path: same parameter layout as when the state was saved, no lookup by ID needed
+            juce::RangedAudioParameter* parameter = nullptr;
+            if (i < parameters.size()) {
+                auto* candidate = dynamic_cast<juce::RangedAudioParameter*>(parameters.getUnchecked(i));
+                if (candidate != nullptr && candidate->paramID.getNumBytesAsUTF8() == static_cast<size_t>(idLength)
+                    && std::memcmp(candidate->paramID.toRawUTF8(), id, static_cast<size_t>(idLength)) == 0)
+                    parameter = candidate;
+            }
+            if (parameter == nullptr)
+                parameter = apvts.getParameter(juce::String::fromUTF8(id, idLength));
+
+            // Parameters that no longer exist are skipped
+            if (parameter != nullptr)
+                values.emplace_back(parameter, value);
+        }
+
+        if (stream.getNumBytesRemaining() < 4)
+            return false;
+        const int extraStateSize = stream.readInt();
+        if (extraStateSize < 0 || extraStateSize > stream.getNumBytesRemaining())
+            return false;
+        juce::ValueTree extra;
+        if (extraStateSize > 0)
+            extra = juce::ValueTree::readFromData(static_cast<const char*>(data) + stream.getPosition(),
+                                                  static_cast<size_t>(extraStateSize));
+
+        // Unchanged parameters are not touched (no listener callbacks)
+        for (const auto& entry : values)
+            if (entry.first->getValue() != entry.second)
+                entry.first->setValueNotifyingHost(entry.second);
+        // A state without (readable) non-parameter state resets it, so nothing from the previous state is left over
+        applyNonParameterState(apvts, extra.isValid() ? extra : juce::ValueTree(apvts.state.getType()));
+        return true;
+    }
+
+    /// \brief The previous format: APVTS ValueTree as XML, written with AudioProcessor::copyXmlToBinary()
+    static bool readLegacyXml(juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes) {
+        std::unique_ptr<juce::XmlElement> xmlState = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+        if (xmlState == nullptr || !xmlState->hasTagName(apvts.state.getType()))
+            return false;
+        apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+        return true;
+    }
+
+    /// \brief The previous format, kept for comparisons (see Benchmarks/StateBenchmark.cpp)
+    static void writeLegacyXml(juce::AudioProcessorValueTreeState& apvts, juce::MemoryBlock& destData) {
+        std::unique_ptr<juce::XmlElement> xml = apvts.copyState().createXml();
+        juce::AudioProcessor::copyXmlToBinary(*xml, destData);
+    }
+
+private:
+    /// \brief Writes the binary format, with getValue() returning the normalised value of each parameter
+    template<typename GetValue>
+    static void writeBinary(juce::AudioProcessorValueTreeState& apvts, GetValue&& getValue, const juce::ValueTree& extra,
+                            juce::MemoryBlock& destData) {
+        const auto& parameters = apvts.processor.getParameters();
+        juce::MemoryOutputStream stream(destData, false);
+        stream.writeInt(static_cast<int>(magic));
+        stream.writeInt(static_cast<int>(currentVersion));
+        stream.writeInt(parameters.size());
+
+        for (auto* parameter : parameters) {
+            auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+            const auto& id = withID != nullptr ? withID->paramID : juce::String();
+            const auto numBytes = id.getNumBytesAsUTF8();
+            jassert(numBytes <= 0xffff);
+            stream.writeShort(static_cast<short>(numBytes));
+            stream.write(id.toRawUTF8(), numBytes);
+            stream.writeFloat(getValue(*parameter));
+        }
+
+        // Everything in the tree that is not a parameter
+        juce::MemoryOutputStream extraState;
+        if (extra.getNumProperties() > 0 || extra.getNumChildren() > 0)
+            extra.writeToStream(extraState);
+        stream.writeInt(static_cast<int>(extraState.getDataSize()));
+        stream.write(extraState.getData(), extraState.getDataSize());
+    }
+
+    static bool isParameterNode(const juce::ValueTree& child) {
+        return child.hasType("PARAM");
+    }
+
+    /// \brief Copy of an APVTS tree without the parameter nodes
+    static juce::ValueTree getNonParameterState(const juce::ValueTree& state) {
+        juce::ValueTree extra(state.getType());
+        extra.copyPropertiesFrom(state, nullptr);
+        for (const auto& child : state)
+            if (!isParameterNode(child))
+                extra.appendChild(child.createCopy(), nullptr);
+        return extra;
+    }
+
+    /// \brief Replaces all non-parameter properties and children of the APVTS tree
+    static void applyNonParameterState(juce::AudioProcessorValueTreeState& apvts, const juce::ValueTree& extra) {
+        apvts.state.copyPropertiesFrom(extra, nullptr);
+        for (int i = apvts.state.getNumChildren(); --i >= 0;)
+            if (!isParameterNode(apvts.state.getChild(i)))
+                apvts.state.removeChild(i, nullptr);
+        for (const auto& child : extra)
+            apvts.state.appendChild(child.createCopy(), nullptr);
+    }
+};
+
+#endif //ULTRALIGHTJUCE_STATESERIALIZER_H
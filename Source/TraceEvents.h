@@ -0,0 +1,218 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+#ifndef ULTRALIGHTJUCE_TRACEEVENTS_H
+#define ULTRALIGHTJUCE_TRACEEVENTS_H
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+/// \brief Records spans of UI work, JS interop and audio processing, exported as Chrome trace-event JSON
+/// (open it in https://ui.perfetto.dev or chrome://tracing).
+///
+/// Instrument code with ULJ_TRACE_SCOPE("name") or ULJ_TRACE_SCOPE_DETAIL("name", detail). The macros compile to
+/// nothing unless the project is configured with -DULTRALIGHTJUCE_ENABLE_TRACING=ON.
+///
+/// Every thread writes into its own ring buffer (the newest BUFFER_CAPACITY spans are kept), so recording is lock-free,
+/// wait-free and doesn't allocate, which makes it safe on the audio thread. The buffers are a fixed pool of MAX_THREADS
+/// in zero-initialized static storage (only the pages that are written to use memory); the first span of a thread
+/// claims the next one with an atomic increment. Slots are never reused, so short-lived threads use them up as well:
+/// threads beyond MAX_THREADS are not recorded, but counted, and the exported trace says so (a global instant event at
+/// the first refused thread, and maxThreads/threadsNotTraced in its otherData). Names must be string literals (only
+/// the pointer is stored), details are copied and truncated to MAX_DETAIL_LENGTH characters.
+class TraceEvents {
+public:
+    static constexpr size_t BUFFER_CAPACITY = 1 << 16;
+    static constexpr size_t MAX_DETAIL_LENGTH = 47;
+    static constexpr int MAX_THREADS = 16;
+
+    /// \brief Records one span from its construction until its destruction
+    class Scope {
+    public:
+        explicit Scope(const char* nameIn, const char* detailIn = nullptr) noexcept
+                : name(nameIn), detail(detailIn), start(now()) {}
+
+        ~Scope() {
+            if (auto* buffer = getThreadBuffer())
+                buffer->add(name, detail, start, now() - start);
+        }
+
+    private:
+        const char* name;
+        const char* detail;
+        const int64_t start;
+    };
+
+    /// \brief Names the calling thread in the trace (the pointer is stored, so pass a string literal)
+    static void setCurrentThreadName(const char* name) noexcept {
+        if (auto* buffer = getThreadBuffer())
+            buffer->threadName.store(name, std::memory_order_relaxed);
+    }
+
+    /// \brief Writes all recorded spans of all threads as Chrome trace-event JSON. Can be called while recording (it
+    /// takes no lock the recording threads could wait for), spans written into a buffer during the export may appear
+    /// half-written.
+    static bool writeChromeJson(const juce::File& file) {
+        file.getParentDirectory().createDirectory();
+        juce::FileOutputStream out(file);
+        if (!out.openedOk())
+            return false;
+        out.setPosition(0);
+        out.truncate();
+
+        const int threadsNotTraced = getThreadsNotTraced().load(std::memory_order_relaxed);
+        out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"maxThreads\":" << MAX_THREADS
+            << ",\"threadsNotTraced\":" << threadsNotTraced << "},\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            if (!first)
+                out << ",\n";
+            first = false;
+        };
+
+        const int numThreads = juce::jmin(getNextThreadSlot().load(std::memory_order_acquire), MAX_THREADS);
+        for (int slot = 0; slot < numThreads; ++slot) {
+            const auto* buffer = &getThreadBuffers()[slot];
+            // Claimed, but the thread may not have finished setting it up yet
+            if (!buffer->claimed.load(std::memory_order_acquire))
+                continue;
+            separator();
+            const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":" << juce::JSON::toString(threadName != nullptr
+                                                                      ? juce::String(threadName)
+                                                                      : "Thread " + juce::String(buffer->threadId)) << "}}";
+
+            const auto written = buffer->written.load(std::memory_order_acquire);
+            const auto count = juce::jmin<uint64_t>(written, BUFFER_CAPACITY);
+            for (uint64_t i = written - count; i < written; ++i) {
+                const auto& span = buffer->spans[i % BUFFER_CAPACITY];
+                separator();
+                out << "{\"name\":" << juce::JSON::toString(juce::String(span.name))
+                    << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"ts\":" << juce::String(static_cast<double>(span.start) * 1.0e-3, 3)
+                    << ",\"dur\":" << juce::String(static_cast<double>(span.duration) * 1.0e-3, 3);
+                if (span.detail[0] != '\0')
+                    out << ",\"args\":{\"detail\":" << juce::JSON::toString(juce::String(span.detail)) << "}";
+                out << "}";
+            }
+        }
+        if (threadsNotTraced > 0) {
+            separator();
+            out << "{\"name\":\"Trace buffers exhausted, later threads are not traced\",\"ph\":\"i\",\"s\":\"g\","
+                << "\"pid\":1,\"tid\":0,\"ts\":"
+                << juce::String(static_cast<double>(getFirstThreadNotTraced().load(std::memory_order_relaxed)) * 1.0e-3, 3)
+                << ",\"args\":{\"maxThreads\":" << MAX_THREADS << ",\"threadsNotTraced\":" << threadsNotTraced << "}}";
+        }
+        out << "\n]}\n";
+        return true;
+    }
+
+    /// \brief Default location of exported traces: <user app data>/UltralightJUCE/Traces/trace-<time>.json
+    static juce::File getDefaultTraceFile() {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                .getChildFile("UltralightJUCE").getChildFile("Traces")
+                .getChildFile("trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+    }
+
+    /// \brief Nanoseconds since the first trace call of the process
+    static int64_t now() noexcept {
+        static const auto origin = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+private:
+    // All members are initialized, so the buffers can be constant-initialized (zero pages in static storage)
+    struct Span {
+        const char* name = nullptr;
+        int64_t start = 0;
+        int64_t duration = 0;
+        char detail[MAX_DETAIL_LENGTH + 1] {};
+    };
+
+    struct ThreadBuffer {
+        // Only called by the owning thread
+        void add(const char* name, const char* detail, int64_t start, int64_t duration) noexcept {
+            const auto index = written.load(std::memory_order_relaxed);
+            auto& span = spans[index % BUFFER_CAPACITY];
+            span.name = name;
+            span.start = start;
+            span.duration = duration;
+            span.detail[0] = '\0';
+            if (detail != nullptr) {
+                std::strncpy(span.detail, detail, MAX_DETAIL_LENGTH);
+                span.detail[MAX_DETAIL_LENGTH] = '\0';
+            }
+            written.store(index + 1, std::memory_order_release);
+        }
+
+        std::atomic<bool> claimed { false };    // Set (release) once threadId is valid
+        int threadId = 0;
+        std::atomic<const char*> threadName { nullptr };
+        std::atomic<uint64_t> written { 0 };
+        Span spans[BUFFER_CAPACITY] {};
+    };
+
+    // Never reused: spans of threads that ended can still be exported
+    static ThreadBuffer* getThreadBuffers() noexcept {
+        static ThreadBuffer buffers[MAX_THREADS];
+        return buffers;
+    }
+
+    static std::atomic<int>& getNextThreadSlot() noexcept {
+        static std::atomic<int> nextSlot { 0 };
+        return nextSlot;
+    }
+
+    // Threads that found all buffers taken, and when the first of them tried to record
+    static std::atomic<int>& getThreadsNotTraced() noexcept {
+        static std::atomic<int> threadsNotTraced { 0 };
+        return threadsNotTraced;
+    }
+
+    static std::atomic<int64_t>& getFirstThreadNotTraced() noexcept {
+        static std::atomic<int64_t> firstThreadNotTraced { 0 };
+        return firstThreadNotTraced;
+    }
+
+    /// \brief The calling thread's buffer, nullptr if all MAX_THREADS are taken. No locks, no allocations.
+    static ThreadBuffer* getThreadBuffer() noexcept {
+        thread_local ThreadBuffer* buffer = [] () -> ThreadBuffer* {
+            const int slot = getNextThreadSlot().fetch_add(1, std::memory_order_acq_rel);
+            if (slot >= MAX_THREADS) {
+                if (getThreadsNotTraced().fetch_add(1, std::memory_order_relaxed) == 0)
+                    getFirstThreadNotTraced().store(now(), std::memory_order_relaxed);
+                return nullptr;
+            }
+            auto* claimed = &getThreadBuffers()[slot];
+            claimed->threadId = slot + 1;
+            if (juce::MessageManager::getInstanceWithoutCreating() != nullptr
+                && juce::MessageManager::getInstanceWithoutCreating()->isThisTheMessageThread())
+                claimed->threadName.store("Message thread", std::memory_order_relaxed);
+            claimed->claimed.store(true, std::memory_order_release);
+            return claimed;
+        }();
+        return buffer;
+    }
+};
+
+#if ULTRALIGHTJUCE_ENABLE_TRACING
+#define ULJ_TRACE_CONCAT_INNER(a, b) a##b
+#define ULJ_TRACE_CONCAT(a, b) ULJ_TRACE_CONCAT_INNER(a, b)
+/// Records a span from here until the end of the enclosing scope
+#define ULJ_TRACE_SCOPE(name) TraceEvents::Scope ULJ_TRACE_CONCAT(ulTraceScope, __LINE__)(name)
+/// Same, with a detail string that is shown in the span's args (e.g. the name of the invoked JS function)
+#define ULJ_TRACE_SCOPE_DETAIL(name, detail) TraceEvents::Scope ULJ_TRACE_CONCAT(ulTraceScope, __LINE__)(name, detail)
+/// Names the calling thread in the trace
+#define ULJ_TRACE_THREAD_NAME(name) TraceEvents::setCurrentThreadName(name)
+#else
+#define ULJ_TRACE_SCOPE(name) ((void) 0)
+#define ULJ_TRACE_SCOPE_DETAIL(name, detail) ((void) 0)
+#define ULJ_TRACE_THREAD_NAME(name) ((void) 0)
+#endif
+
+#endif //ULTRALIGHTJUCE_TRACEEVENTS_H
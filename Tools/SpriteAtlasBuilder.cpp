@@ -0,0 +1,50 @@
+//
+// Created by Max on 18/10/2026.
+//
+
+// Build step: pre-renders the sprite atlas (see Source/SpriteAtlas.h) for one device scale, so the plugin doesn't have
+// to rasterize the control SVGs when the first editor opens. Run by CMake for every scale in SPRITE_ATLAS_SCALES.
+//
+// Usage: UltralightJUCE_SpriteAtlasBuilder --resources <Resources folder> --scale 2 --output <file.png>
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <iostream>
+
+#include "SpriteAtlas.h"
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    if (!args.containsOption("--resources") || !args.containsOption("--scale") || !args.containsOption("--output")) {
+        std::cerr << "Usage: " << argv[0] << " --resources <Resources folder> --scale <device scale> --output <file.png>" << std::endl;
+        return 1;
+    }
+    // Drawables are Components, they need a message thread
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::File resources(args.getFileForOption("--resources"));
+    const float scale = args.getValueForOption("--scale").getFloatValue();
+    const juce::File output(args.getFileForOption("--output"));
+    if (!resources.isDirectory()) {
+        std::cerr << "Resources folder not found: " << resources.getFullPathName() << std::endl;
+        return 1;
+    }
+    if (scale <= 0.0f) {
+        std::cerr << "Invalid scale " << args.getValueForOption("--scale") << std::endl;
+        return 1;
+    }
+
+    const auto png = SpriteAtlas::renderPNG(scale, [&resources](const char* path) {
+        return resources.getChildFile(path).loadFileAsString();
+    });
+    if (png.isEmpty()) {
+        std::cerr << "Couldn't render the sprite atlas, check the SVG paths in SpriteAtlas::getSprites()" << std::endl;
+        return 1;
+    }
+    output.getParentDirectory().createDirectory();
+    if (!output.replaceWithData(png.getData(), png.getSize())) {
+        std::cerr << "Couldn't write " << output.getFullPathName() << std::endl;
+        return 1;
+    }
+    std::cout << "Sprite atlas @" << scale << "x: " << output.getFullPathName() << " (" << png.getSize() << " bytes)" << std::endl;
+    return 0;
+}